@@ -0,0 +1,99 @@
+#!/bin/bash
+
+# Compile-time regression benchmark for skc.
+#
+# Builds the standard library, skjson and skdb from scratch with
+# `skc --profile-compile` and compares the time of each build with the
+# baseline stored in baseline.json. Fails if any build is more than
+# SKC_BENCH_TOLERANCE percent (default: 10) slower than its baseline.
+#
+# Usage: compile_time.sh [--update]
+#   --update    record the current timings as the new baseline.
+#
+# The per-phase profiles are kept in $SKC_BENCH_OUT/<name>/profile.json
+# (and profile.trace.json) to investigate regressions. Dependencies are
+# compiled by separate skc invocations which share the profile prefix, so
+# the profile only covers the last one, i.e. the benchmarked package.
+
+set -euo pipefail
+
+HERE=$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)
+ROOT=$(cd "$HERE/../../.." && pwd)
+BASELINE=$HERE/baseline.json
+TOLERANCE=${SKC_BENCH_TOLERANCE:-10}
+OUT=${SKC_BENCH_OUT:-$ROOT/build/bench/compile_time}
+
+UPDATE=0
+if [ "${1:-}" == "--update" ]; then
+    UPDATE=1
+fi
+
+# name:package directory:skargo build arguments
+BENCHMARKS=(
+    "std:skiplang/prelude:--lib"
+    "skjson:skiplang/skjson:--bin skjson"
+    "skdb:sql:--bin skdb"
+)
+
+RESULTS="{}"
+for bench in "${BENCHMARKS[@]}"; do
+    IFS=: read -r name dir args <<< "$bench"
+    rm -rf "${OUT:?}/$name"
+    mkdir -p "$OUT/$name"
+
+    start=$(date +%s%N)
+    # shellcheck disable=SC2086 # $args holds several arguments
+    (cd "$ROOT/$dir" && skargo build --release -q $args \
+        --target-dir "$OUT/$name/target" \
+        --skcopt=--profile-compile="$OUT/$name/profile")
+    end=$(date +%s%N)
+
+    RESULTS=$(jq \
+        --arg name "$name" \
+        --argjson ms $(((end - start) / 1000000)) \
+        --slurpfile profile "$OUT/$name/profile.json" \
+        '. + {($name): {wallMs: $ms, phases: ($profile[0].phases | map_values(.wallMs))}}' \
+        <<< "$RESULTS")
+done
+
+if [ "$UPDATE" == 1 ]; then
+    jq . <<< "$RESULTS" > "$BASELINE"
+    echo "Updated $BASELINE"
+    exit 0
+fi
+
+if [ ! -f "$BASELINE" ]; then
+    echo "No baseline found, run $0 --update first." >&2
+    exit 1
+fi
+
+STATUS=0
+for name in $(jq -r 'keys[]' <<< "$RESULTS"); do
+    current=$(jq --arg name "$name" '.[$name].wallMs' <<< "$RESULTS")
+    baseline=$(jq --arg name "$name" '.[$name].wallMs // empty' "$BASELINE")
+    if [ -z "$baseline" ]; then
+        printf "%-8s %8d ms (no baseline)\n" "$name" "$current"
+        continue
+    fi
+    delta=$(((current - baseline) * 100 / baseline))
+    verdict=OK
+    if ((delta > TOLERANCE)); then
+        verdict=REGRESSION
+        STATUS=1
+    fi
+    printf "%-8s %8d ms  baseline %8d ms  %+4d%%  %s\n" \
+        "$name" "$current" "$baseline" "$delta" "$verdict"
+
+    # Point at the phases that got slower to help narrow it down.
+    jq -r --arg name "$name" --argjson tolerance "$TOLERANCE" \
+        --slurpfile baseline "$BASELINE" '
+        .[$name].phases as $cur
+        | ($baseline[0][$name].phases // {}) as $base
+        | $cur | keys[]
+        | select($base[.] != null and $base[.] > 0)
+        | select(($cur[.] - $base[.]) * 100 / $base[.] > $tolerance)
+        | "    \(.): \($cur[.] | round) ms, was \($base[.] | round) ms"' \
+        <<< "$RESULTS"
+done
+
+exit $STATUS
@@ -47,6 +47,13 @@ static __thread struct sk_obstack* page = NULL;
 static __thread char* head = NULL;
 static __thread char* end = NULL;
 
+#ifdef SKIP_COUNT_ALLOCATIONS
+// The number of bytes allocated on this thread's obstacks so far. It is not
+// decreased when memory is collected. Only maintained in benchmark builds, so
+// that the allocation fast path does not pay for it otherwise.
+static __thread uint64_t allocated_bytes = 0;
+#endif
+
 #ifdef SKIP32
 static struct sk_obstack* free_list = NULL;
 
@@ -149,6 +156,9 @@ char* SKIP_Obstack_alloc(size_t size) {
   char* result;
   size += 8;
   size = (size + 7) & ~7;
+#ifdef SKIP_COUNT_ALLOCATIONS
+  allocated_bytes += size;
+#endif
 
   if (head + size >= end) {
     if (size + sizeof(sk_obstack_t) > PAGE_SIZE) {
@@ -167,6 +177,15 @@ char* SKIP_Obstack_alloc(size_t size) {
   return result;
 }
 
+// -1 when allocations are not counted.
+SkipInt SKIP_Obstack_allocated_bytes() {
+#ifdef SKIP_COUNT_ALLOCATIONS
+  return allocated_bytes;
+#else
+  return -1;
+#endif
+}
+
 void* SKIP_Obstack_calloc(size_t size) {
   char* result = SKIP_Obstack_alloc(size);
   memset(result, 0, size);
@@ -7,11 +7,22 @@
 #include <stdlib.h>
 #include <string.h>
 #include <sys/errno.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
 #include "runtime.h"
 
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define SKIP_HAS_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
 int64_t SKIP_posix_open(char* path, int64_t oflag, int64_t mode) {
   sk_string_check_c_safe(path);
   int fd = open(path, oflag, mode);
@@ -308,3 +319,586 @@ int64_t SKIP_posix_mkstemp(char* template) {
   free(copy);
   return rv;
 }
+
+int64_t SKIP_posix_fstat_size(int64_t fd) {
+  struct stat st;
+  if (fstat((int)fd, &st) == -1) {
+    return (int64_t)(-errno);
+  }
+  return (int64_t)st.st_size;
+}
+
+// Mappings are passed around as integer addresses so that failures can be
+// reported as -errno, like the other calls in this file.
+int64_t SKIP_posix_mmap(int64_t fd, int64_t len) {
+  if (len == 0) {
+    // mmap() rejects empty mappings, none of the accessors below will
+    // dereference this.
+    return 0;
+  }
+  void* addr = mmap(NULL, (size_t)len, PROT_READ, MAP_PRIVATE, (int)fd, 0);
+  if (addr == MAP_FAILED) {
+    return (int64_t)(-errno);
+  }
+  // Best effort: let the kernel read ahead aggressively and drop pages
+  // behind the reader.
+  madvise(addr, (size_t)len, MADV_SEQUENTIAL);
+  return (int64_t)addr;
+}
+
+void SKIP_posix_munmap(int64_t addr, int64_t len) {
+  if (len == 0) {
+    return;
+  }
+  if (munmap((void*)addr, (size_t)len) == -1) {
+    perror("munmap");
+    exit(EXIT_FAILURE);
+  }
+}
+
+void* SKIP_posix_mmap_ptr(int64_t addr, int64_t offset) {
+  return (char*)addr + offset;
+}
+
+uint8_t SKIP_posix_mmap_get_byte(int64_t addr, int64_t index) {
+  return ((uint8_t*)addr)[index];
+}
+
+int64_t SKIP_posix_mmap_index_of(int64_t addr, int64_t start, int64_t end,
+                                 int64_t byte) {
+  if (start >= end) {
+    return -1;
+  }
+  char* base = (char*)addr;
+  char* found = memchr(base + start, (int)byte, (size_t)(end - start));
+  if (found == NULL) {
+    return -1;
+  }
+  return (int64_t)(found - base);
+}
+
+char* SKIP_posix_mmap_string(int64_t addr, int64_t start, int64_t end) {
+  return sk_string_create((char*)addr + start, (uint32_t)(end - start));
+}
+
+/*****************************************************************************/
+/* Queue of asynchronous file operations. */
+/*****************************************************************************/
+
+// Operations are identified by a ticket, their index in the ring's table.
+// Buffers are owned by the queue rather than borrowed from the Skip heap,
+// since the GC may move or free an object while the kernel still writes to
+// it: writes copy their payload at submission and reads are copied out by
+// SKIP_posix_ioring_copy_result() once they are done.
+//
+// When io_uring is not available (non-Linux systems, old kernels, or
+// sandboxes that forbid io_uring_setup), operations are performed with
+// blocking calls when they are submitted, so that callers do not need to
+// handle both cases.
+
+#define SK_IORING_READ 0
+#define SK_IORING_WRITE 1
+#define SK_IORING_FSYNC 2
+#define SK_IORING_FDATASYNC 3
+
+typedef struct {
+  int kind;
+  int fd;
+  int64_t offset;
+  struct iovec iov;
+  int done;
+  int64_t result;
+  int64_t next_free;
+} sk_ioring_op;
+
+typedef struct {
+  sk_ioring_op** ops;
+  int64_t ops_count;
+  int64_t ops_capacity;
+  // Released tickets, chained through next_free. Live operations have a
+  // next_free of -2.
+  int64_t free_list;
+  // Operations queued since the last submission.
+  int64_t unsubmitted;
+  // Operations submitted but not yet completed.
+  int64_t in_flight;
+  // -errno that the next submission fails with, see
+  // SKIP_posix_ioring_fail_next_submit().
+  int64_t submit_error;
+#ifdef SKIP_HAS_IO_URING
+  int ring_fd;
+  unsigned sq_entries;
+  unsigned cq_entries;
+  unsigned* sq_head;
+  unsigned* sq_tail;
+  unsigned sq_mask;
+  unsigned* sq_array;
+  struct io_uring_sqe* sqes;
+  unsigned* cq_head;
+  unsigned* cq_tail;
+  unsigned cq_mask;
+  struct io_uring_cqe* cqes;
+  void* sq_ring;
+  size_t sq_ring_size;
+  void* cq_ring;
+  size_t cq_ring_size;
+  size_t sqes_size;
+#endif
+} sk_ioring;
+
+static void* sk_ioring_malloc(size_t size) {
+  void* result = malloc(size);
+  if (result == NULL) {
+    perror("malloc");
+    exit(EXIT_FAILURE);
+  }
+  return result;
+}
+
+static sk_ioring_op* sk_ioring_get_op(sk_ioring* ring, int64_t ticket) {
+  if (ticket < 0 || ticket >= ring->ops_count ||
+      ring->ops[ticket]->next_free != -2) {
+    fprintf(stderr, "Invalid I/O ticket: %lld\n", (long long)ticket);
+    exit(EXIT_FAILURE);
+  }
+  return ring->ops[ticket];
+}
+
+static void sk_ioring_perform(sk_ioring_op* op) {
+  ssize_t rv;
+  do {
+    switch (op->kind) {
+      case SK_IORING_READ:
+        rv = op->offset < 0
+                 ? read(op->fd, op->iov.iov_base, op->iov.iov_len)
+                 : pread(op->fd, op->iov.iov_base, op->iov.iov_len,
+                         (off_t)op->offset);
+        break;
+      case SK_IORING_WRITE:
+        rv = op->offset < 0
+                 ? write(op->fd, op->iov.iov_base, op->iov.iov_len)
+                 : pwrite(op->fd, op->iov.iov_base, op->iov.iov_len,
+                          (off_t)op->offset);
+        break;
+      case SK_IORING_FDATASYNC:
+#ifdef __APPLE__
+        rv = fsync(op->fd);
+#else
+        rv = fdatasync(op->fd);
+#endif
+        break;
+      default:
+        rv = fsync(op->fd);
+        break;
+    }
+  } while (rv == -1 && errno == EINTR);
+  op->result = rv == -1 ? (int64_t)(-errno) : (int64_t)rv;
+  op->done = 1;
+}
+
+#ifdef SKIP_HAS_IO_URING
+
+static int sk_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                             unsigned flags) {
+  return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags,
+                      NULL, 0);
+}
+
+static int sk_ioring_setup(sk_ioring* ring, unsigned entries) {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+  if (fd < 0) {
+    return 0;
+  }
+  size_t sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  size_t cq_ring_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  int single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    if (cq_ring_size > sq_ring_size) {
+      sq_ring_size = cq_ring_size;
+    }
+    cq_ring_size = sq_ring_size;
+  }
+  void* sq_ring = mmap(NULL, sq_ring_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+  if (sq_ring == MAP_FAILED) {
+    close(fd);
+    return 0;
+  }
+  void* cq_ring = sq_ring;
+  if (!single_mmap) {
+    cq_ring = mmap(NULL, cq_ring_size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    if (cq_ring == MAP_FAILED) {
+      munmap(sq_ring, sq_ring_size);
+      close(fd);
+      return 0;
+    }
+  }
+  size_t sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  void* sqes = mmap(NULL, sqes_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+  if (sqes == MAP_FAILED) {
+    if (!single_mmap) {
+      munmap(cq_ring, cq_ring_size);
+    }
+    munmap(sq_ring, sq_ring_size);
+    close(fd);
+    return 0;
+  }
+
+  char* sq = (char*)sq_ring;
+  char* cq = (char*)cq_ring;
+  ring->ring_fd = fd;
+  ring->sq_entries = params.sq_entries;
+  ring->cq_entries = params.cq_entries;
+  ring->sq_head = (unsigned*)(sq + params.sq_off.head);
+  ring->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+  ring->sq_mask = *(unsigned*)(sq + params.sq_off.ring_mask);
+  ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+  ring->sqes = (struct io_uring_sqe*)sqes;
+  ring->cq_head = (unsigned*)(cq + params.cq_off.head);
+  ring->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+  ring->cq_mask = *(unsigned*)(cq + params.cq_off.ring_mask);
+  ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+  ring->sq_ring = sq_ring;
+  ring->sq_ring_size = sq_ring_size;
+  ring->cq_ring = single_mmap ? NULL : cq_ring;
+  ring->cq_ring_size = cq_ring_size;
+  ring->sqes_size = sqes_size;
+  return 1;
+}
+
+// Moves the available completions to their operations, after waiting for at
+// least `min_complete` of them.
+static int64_t sk_ioring_reap(sk_ioring* ring, unsigned min_complete) {
+  if (min_complete > 0) {
+    int rv;
+    do {
+      rv = sk_io_uring_enter(ring->ring_fd, 0, min_complete,
+                             IORING_ENTER_GETEVENTS);
+    } while (rv == -1 && errno == EINTR);
+    if (rv == -1) {
+      return (int64_t)(-errno);
+    }
+  }
+  unsigned head = *ring->cq_head;
+  unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+  while (head != tail) {
+    struct io_uring_cqe* cqe = &ring->cqes[head & ring->cq_mask];
+    sk_ioring_op* op = ring->ops[cqe->user_data];
+    op->result = (int64_t)cqe->res;
+    op->done = 1;
+    ring->in_flight--;
+    head++;
+  }
+  __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+  return 0;
+}
+
+static int64_t sk_ioring_flush(sk_ioring* ring) {
+  while (ring->unsubmitted > 0) {
+    int rv = sk_io_uring_enter(ring->ring_fd, (unsigned)ring->unsubmitted, 0, 0);
+    if (rv == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      if ((errno == EAGAIN || errno == EBUSY) && ring->in_flight > 0) {
+        // The kernel is short on resources or the completion queue is
+        // full: make room before retrying.
+        int64_t reaped = sk_ioring_reap(ring, 1);
+        if (reaped < 0) {
+          return reaped;
+        }
+        continue;
+      }
+      return (int64_t)(-errno);
+    }
+    ring->unsubmitted -= rv;
+    ring->in_flight += rv;
+  }
+  return 0;
+}
+
+static void sk_ioring_push(sk_ioring* ring, int64_t ticket) {
+  // Never have more operations outstanding than the completion queue can
+  // hold, so that completions cannot be dropped.
+  while (ring->unsubmitted + ring->in_flight >= ring->cq_entries ||
+         ring->unsubmitted >= ring->sq_entries) {
+    int64_t rv = sk_ioring_flush(ring);
+    if (rv == 0) {
+      rv = sk_ioring_reap(ring, 1);
+    }
+    if (rv < 0) {
+      errno = (int)(-rv);
+      perror("io_uring_enter");
+      exit(EXIT_FAILURE);
+    }
+  }
+  sk_ioring_op* op = ring->ops[ticket];
+  unsigned tail = *ring->sq_tail;
+  unsigned index = tail & ring->sq_mask;
+  struct io_uring_sqe* sqe = &ring->sqes[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->fd = op->fd;
+  sqe->user_data = (uint64_t)ticket;
+  switch (op->kind) {
+    case SK_IORING_READ:
+    case SK_IORING_WRITE:
+      sqe->opcode =
+          op->kind == SK_IORING_READ ? IORING_OP_READV : IORING_OP_WRITEV;
+      sqe->addr = (uint64_t)(uintptr_t)&op->iov;
+      sqe->len = 1;
+      sqe->off = (uint64_t)op->offset;
+      break;
+    default:
+      sqe->opcode = IORING_OP_FSYNC;
+      sqe->fsync_flags =
+          op->kind == SK_IORING_FDATASYNC ? IORING_FSYNC_DATASYNC : 0;
+      break;
+  }
+  ring->sq_array[index] = index;
+  __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+  ring->unsubmitted++;
+}
+
+#endif
+
+void* SKIP_posix_ioring_create(int64_t entries) {
+  sk_ioring* ring = (sk_ioring*)sk_ioring_malloc(sizeof(sk_ioring));
+  memset(ring, 0, sizeof(sk_ioring));
+  ring->free_list = -1;
+#ifdef SKIP_HAS_IO_URING
+  ring->ring_fd = -1;
+  if (entries > 0) {
+    sk_ioring_setup(ring, (unsigned)entries);
+  }
+#else
+  (void)entries;
+#endif
+  return ring;
+}
+
+char SKIP_posix_ioring_uses_io_uring(void* ringp) {
+#ifdef SKIP_HAS_IO_URING
+  return ((sk_ioring*)ringp)->ring_fd >= 0;
+#else
+  (void)ringp;
+  return 0;
+#endif
+}
+
+static int64_t sk_ioring_add(sk_ioring* ring, int kind, int64_t fd,
+                             char* data, int64_t len, int64_t offset) {
+  int64_t ticket = ring->free_list;
+  if (ticket >= 0) {
+    ring->free_list = ring->ops[ticket]->next_free;
+  } else {
+    if (ring->ops_count == ring->ops_capacity) {
+      int64_t capacity = ring->ops_capacity == 0 ? 16 : ring->ops_capacity * 2;
+      sk_ioring_op** ops = (sk_ioring_op**)realloc(
+          ring->ops, sizeof(sk_ioring_op*) * (size_t)capacity);
+      if (ops == NULL) {
+        perror("realloc");
+        exit(EXIT_FAILURE);
+      }
+      ring->ops = ops;
+      ring->ops_capacity = capacity;
+    }
+    ticket = ring->ops_count++;
+    ring->ops[ticket] = (sk_ioring_op*)sk_ioring_malloc(sizeof(sk_ioring_op));
+  }
+  sk_ioring_op* op = ring->ops[ticket];
+  memset(op, 0, sizeof(sk_ioring_op));
+  op->kind = kind;
+  op->fd = (int)fd;
+  op->offset = offset;
+  op->next_free = -2;
+  if (len > 0) {
+    op->iov.iov_base = sk_ioring_malloc((size_t)len);
+    op->iov.iov_len = (size_t)len;
+    if (data != NULL) {
+      memcpy(op->iov.iov_base, data, (size_t)len);
+    }
+  }
+#ifdef SKIP_HAS_IO_URING
+  if (ring->ring_fd >= 0) {
+    sk_ioring_push(ring, ticket);
+    return ticket;
+  }
+#endif
+  ring->unsubmitted++;
+  return ticket;
+}
+
+int64_t SKIP_posix_ioring_read(void* ringp, int64_t fd, int64_t len,
+                               int64_t offset) {
+  return sk_ioring_add((sk_ioring*)ringp, SK_IORING_READ, fd, NULL, len,
+                       offset);
+}
+
+int64_t SKIP_posix_ioring_write(void* ringp, int64_t fd, char* buf,
+                                int64_t len, int64_t offset) {
+  return sk_ioring_add((sk_ioring*)ringp, SK_IORING_WRITE, fd, buf, len,
+                       offset);
+}
+
+int64_t SKIP_posix_ioring_fsync(void* ringp, int64_t fd, char datasync) {
+  return sk_ioring_add((sk_ioring*)ringp,
+                       datasync ? SK_IORING_FDATASYNC : SK_IORING_FSYNC, fd,
+                       NULL, 0, 0);
+}
+
+// Completes the operations queued since the last submission with `error`,
+// once the kernel refused them. They can then be waited for and released
+// like any other operation.
+static void sk_ioring_fail_unsubmitted(sk_ioring* ring, int64_t error) {
+#ifdef SKIP_HAS_IO_URING
+  if (ring->ring_fd >= 0) {
+    // The kernel consumes entries in order and only reads the tail in
+    // io_uring_enter(), so the last `unsubmitted` entries can be taken back.
+    unsigned tail = *ring->sq_tail;
+    for (unsigned i = (unsigned)ring->unsubmitted; i > 0; i--) {
+      unsigned index = ring->sq_array[(tail - i) & ring->sq_mask];
+      sk_ioring_op* op = ring->ops[ring->sqes[index].user_data];
+      op->result = error;
+      op->done = 1;
+    }
+    __atomic_store_n(ring->sq_tail, tail - (unsigned)ring->unsubmitted,
+                     __ATOMIC_RELEASE);
+    ring->unsubmitted = 0;
+    return;
+  }
+#endif
+  for (int64_t i = 0; i < ring->ops_count; i++) {
+    sk_ioring_op* op = ring->ops[i];
+    if (op->next_free == -2 && !op->done) {
+      op->result = error;
+      op->done = 1;
+    }
+  }
+  ring->unsubmitted = 0;
+}
+
+// Hands the queued operations to the kernel. Returns 0 or -errno, in which
+// case the operations that could not be submitted complete with that error.
+int64_t SKIP_posix_ioring_submit(void* ringp) {
+  sk_ioring* ring = (sk_ioring*)ringp;
+  if (ring->unsubmitted == 0) {
+    return 0;
+  }
+  int64_t rv = ring->submit_error;
+  ring->submit_error = 0;
+#ifdef SKIP_HAS_IO_URING
+  if (rv == 0 && ring->ring_fd >= 0) {
+    rv = sk_ioring_flush(ring);
+  }
+#endif
+  if (rv < 0) {
+    sk_ioring_fail_unsubmitted(ring, rv);
+    return rv;
+  }
+  if (ring->unsubmitted > 0) {
+    for (int64_t i = 0; i < ring->ops_count; i++) {
+      sk_ioring_op* op = ring->ops[i];
+      if (op->next_free == -2 && !op->done) {
+        sk_ioring_perform(op);
+      }
+    }
+    ring->unsubmitted = 0;
+  }
+  return 0;
+}
+
+// Makes the next submission of queued operations fail with -error, to test
+// how failures are handled.
+void SKIP_posix_ioring_fail_next_submit(void* ringp, int64_t error) {
+  ((sk_ioring*)ringp)->submit_error = -error;
+}
+
+// Returns whether the operation completed, without blocking.
+char SKIP_posix_ioring_is_done(void* ringp, int64_t ticket) {
+  sk_ioring* ring = (sk_ioring*)ringp;
+  sk_ioring_op* op = sk_ioring_get_op(ring, ticket);
+#ifdef SKIP_HAS_IO_URING
+  if (!op->done && ring->ring_fd >= 0) {
+    sk_ioring_reap(ring, 0);
+  }
+#endif
+  return (char)op->done;
+}
+
+// Blocks until the operation completes, submitting it first if needed, and
+// returns its result: a byte count (or 0 for syncs), or -errno. The
+// operation is still pending after an error only if it was in flight and
+// waiting for completions failed.
+int64_t SKIP_posix_ioring_wait(void* ringp, int64_t ticket) {
+  sk_ioring* ring = (sk_ioring*)ringp;
+  sk_ioring_op* op = sk_ioring_get_op(ring, ticket);
+  if (!op->done) {
+    // On failure the operation completes with the error, unless it had
+    // been submitted before, in which case it is waited for below.
+    SKIP_posix_ioring_submit(ring);
+  }
+#ifdef SKIP_HAS_IO_URING
+  while (!op->done) {
+    int64_t rv = sk_ioring_reap(ring, 1);
+    if (rv < 0) {
+      return rv;
+    }
+  }
+#endif
+  return op->result;
+}
+
+// Copies the data of a completed read to `dst`, which must be large enough
+// for the result of the read.
+void SKIP_posix_ioring_copy_result(void* ringp, int64_t ticket, char* dst) {
+  sk_ioring_op* op = sk_ioring_get_op((sk_ioring*)ringp, ticket);
+  if (op->done && op->result > 0) {
+    memcpy(dst, op->iov.iov_base, (size_t)op->result);
+  }
+}
+
+// Frees a completed operation, its ticket can then be reused.
+void SKIP_posix_ioring_release(void* ringp, int64_t ticket) {
+  sk_ioring* ring = (sk_ioring*)ringp;
+  sk_ioring_op* op = sk_ioring_get_op(ring, ticket);
+  if (!op->done) {
+    fprintf(stderr, "Releasing a pending I/O operation: %lld\n",
+            (long long)ticket);
+    exit(EXIT_FAILURE);
+  }
+  free(op->iov.iov_base);
+  op->iov.iov_base = NULL;
+  op->next_free = ring->free_list;
+  ring->free_list = ticket;
+}
+
+// Waits for all the outstanding operations and frees the queue.
+void SKIP_posix_ioring_destroy(void* ringp) {
+  sk_ioring* ring = (sk_ioring*)ringp;
+  for (int64_t i = 0; i < ring->ops_count; i++) {
+    if (ring->ops[i]->next_free == -2) {
+      SKIP_posix_ioring_wait(ring, i);
+    }
+  }
+  for (int64_t i = 0; i < ring->ops_count; i++) {
+    free(ring->ops[i]->iov.iov_base);
+    free(ring->ops[i]);
+  }
+  free(ring->ops);
+#ifdef SKIP_HAS_IO_URING
+  if (ring->ring_fd >= 0) {
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring != NULL) {
+      munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->ring_fd);
+  }
+#endif
+  free(ring);
+}
@@ -24,8 +24,6 @@ SKIP_gc_type_t* get_gc_type(char* skip_object) {
 /* Primitives that are not used in embedded mode. */
 /*****************************************************************************/
 
-void SKIP_Regex_initialize() {}
-
 void SKIP_print_stack_trace() {
   todo("Not implemented", "SKIP_print_stack_trace");
 }
@@ -70,6 +68,16 @@ void SKIP_unsafe_free(char* context) {
   sk_global_unlock();
 }
 
+// Copies obj to the persistent heap, where it stays, whatever obstacks are
+// collected, until it is passed to SKIP_unsafe_free(). For values owned by the
+// host rather than by the reactive state.
+char* SKIP_intern_root(char* obj) {
+  sk_global_lock();
+  char* result = SKIP_intern_shared(obj);
+  sk_global_unlock();
+  return result;
+}
+
 void SKIP_global_lock() {
 #ifdef SKIP64
   sk_global_lock();
@@ -318,6 +318,7 @@ void*(memset)(void* b, int c, size_t len);
 #endif
 
 char* SKIP_Obstack_alloc(size_t size);
+SkipInt SKIP_Obstack_allocated_bytes();
 uint32_t SKIP_String_byteSize(char* str);
 char* SKIP_context_get();
 void* SKIP_copy_with_pages(void* obj, size_t nbr_pages, sk_cell_t* pages);
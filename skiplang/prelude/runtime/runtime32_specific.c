@@ -144,6 +144,10 @@ uint32_t SKIP_get_persistent_size() {
   return (uint32_t)bump_pointer;
 }
 
+int64_t SKIP_persistent_bytes() {
+  return (int64_t)SKIP_get_persistent_size();
+}
+
 void SKIP_time() {
   // Not implemented
 }
@@ -157,6 +161,10 @@ uint64_t SKIP_time_ms() {
   return (((uint64_t)hi) << 32) | ((uint64_t)lo);
 }
 
+uint64_t SKIP_time_us() {
+  return SKIP_time_ms() * 1000;
+}
+
 void SKIP_flush_stdout() {
   // Not implemented
 }
@@ -463,6 +463,13 @@ uint64_t SKIP_time_ms() {
       .count();
 }
 
+uint64_t SKIP_time_us() {
+  using namespace std::chrono;
+
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch())
+      .count();
+}
+
 char* SKIP_unix_strftime(char* formatp, char* timep) {
   struct tm* tm = (struct tm*)timep;
   char buffer[1024];
@@ -14,17 +14,23 @@ uint32_t SKIP_is_string(char* obj) {
   return (uintptr_t)vtable_ptr & 0x2;
 }
 
-void sk_string_set_hash(char* obj) {
-  sk_string_t* str = get_sk_string(obj);
+// Shared by sk_string_set_hash() and SKIP_String_sliceHash(): the bytes are
+// read as (signed) char, so that slices and Strings agree on non-ASCII text.
+static uint32_t sk_hash_bytes(const char* data, SkipInt size) {
   SkipInt acc = 0;
 
-  for (uint32_t i = 0; i < str->size; i++) {
-    acc = acc * 31 + str->data[i];
+  for (SkipInt i = 0; i < size; i++) {
+    acc = acc * 31 + data[i];
   }
 
   // This tag is used by SKIP_is_string to recognize strings.
   acc |= 0x2;
-  str->hash = (uint32_t)acc;
+  return (uint32_t)acc;
+}
+
+void sk_string_set_hash(char* obj) {
+  sk_string_t* str = get_sk_string(obj);
+  str->hash = sk_hash_bytes(str->data, str->size);
 }
 
 // The size of the represented string, in bytes, excludes nul terminator.
@@ -55,6 +61,24 @@ char* sk_string_create(const char* buffer, uint32_t size) {
   return result;
 }
 
+#ifdef SKIP32
+// Bulk allocation for the JavaScript binding, which exports many strings
+// per call: sizes[i] is the byte size of the i-th string and is replaced
+// with its address. The caller then writes the contents in place and calls
+// sk_string_set_hash_n() on the same table.
+void sk_string_alloc_n(uint32_t* sizes, uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+    sizes[i] = (uint32_t)(uintptr_t)sk_string_alloc(sizes[i]);
+  }
+}
+
+void sk_string_set_hash_n(uint32_t* strs, uint32_t count) {
+  for (uint32_t i = 0; i < count; i++) {
+    sk_string_set_hash((char*)(uintptr_t)strs[i]);
+  }
+}
+#endif
+
 char* SKIP_getBuildVersion() {
   return sk_string_create("1", 1);
 }
@@ -176,6 +200,27 @@ char* SKIP_String_concatN(char** arr) {
   return result;
 }
 
+// Hashes the bytes [start, end) of str like sk_string_set_hash(), so that a
+// slice and the string it materializes to have the same hash.
+SkipInt SKIP_String_sliceHash(char* str, SkipInt start, SkipInt end) {
+  return (SkipInt)sk_hash_bytes(str + start, end - start);
+}
+
+// Compares the bytes [start1, end1) of str1 with [start2, end2) of str2,
+// which orders UTF-8 strings by code points.
+SkipInt SKIP_String_sliceCompare(unsigned char* str1, SkipInt start1,
+                                 SkipInt end1, unsigned char* str2,
+                                 SkipInt start2, SkipInt end2) {
+  SkipInt size1 = end1 - start1;
+  SkipInt size2 = end2 - start2;
+  int cmp = memcmp(str1 + start1, str2 + start2,
+                   (size_t)(size1 < size2 ? size1 : size2));
+  if (cmp != 0) {
+    return cmp;
+  }
+  return size1 == size2 ? 0 : (size1 < size2 ? -1 : 1);
+}
+
 SkipInt SKIP_String_cmp(unsigned char* str1, unsigned char* str2) {
   SkipInt size1 = SKIP_String_byteSize((char*)str1);
   SkipInt size2 = SKIP_String_byteSize((char*)str2);
@@ -270,22 +315,375 @@ double atof(const char* s) {
 
 #endif
 
-double SKIP_String__toFloat_raw(char* str) {
-  size_t size = SKIP_String_byteSize((char*)str);
+/*****************************************************************************/
+/* Numeric parsing and formatting. */
+/*****************************************************************************/
+
+#define SK_PARSE_INVALID ((SkipInt)1 << 63)
+
+static int sk_is_digit(unsigned char c) {
+  return c >= '0' && c <= '9';
+}
+
+// Whether the eight bytes of a little-endian word are all ASCII digits:
+// adding 6 carries a digit byte (0x30-0x39) out of its low nibble only when
+// it exceeds '9'.
+static int sk_is_eight_digits(uint64_t word) {
+  return ((word & 0xF0F0F0F0F0F0F0F0) |
+          (((word + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) ==
+         0x3333333333333333;
+}
+
+// The value of eight ASCII digits loaded as a little-endian word, combined
+// pairwise with three multiplications instead of eight.
+static uint64_t sk_parse_eight_digits(uint64_t word) {
+  const uint64_t mask = 0x000000FF000000FF;
+  const uint64_t mul1 = 0x000F424000000064;  // 100 + (1000000 << 32)
+  const uint64_t mul2 = 0x0000271000000001;  // 1 + (10000 << 32)
+  word -= 0x3030303030303030;
+  word = (word * 10) + (word >> 8);
+  word = (((word & mask) * mul1) + (((word >> 16) & mask) * mul2)) >> 32;
+  return word;
+}
+
+// Parses an optional '-' followed by decimal digits. Returns the value, or
+// the smallest Int when the string is not a valid Int: the caller tells it
+// apart from "-9223372036854775808".
+SkipInt SKIP_String_parseInt(unsigned char* str) {
+  uint32_t size = SKIP_String_byteSize((char*)str);
+  uint32_t i = 0;
+  int negative = 0;
+  if (size > 0 && str[0] == '-') {
+    negative = 1;
+    i = 1;
+  }
+  if (i == size) {
+    return SK_PARSE_INVALID;
+  }
+  while (i + 1 < size && str[i] == '0') {
+    i++;
+  }
+  // Any 19 digits fit in 64 bits, the range is checked below.
+  if (size - i > 19) {
+    return SK_PARSE_INVALID;
+  }
+  uint64_t value = 0;
+  for (; size - i >= 8; i += 8) {
+    uint64_t word;
+    memcpy(&word, str + i, 8);
+    if (!sk_is_eight_digits(word)) {
+      return SK_PARSE_INVALID;
+    }
+    value = value * 100000000 + sk_parse_eight_digits(word);
+  }
+  for (; i < size; i++) {
+    if (!sk_is_digit(str[i])) {
+      return SK_PARSE_INVALID;
+    }
+    value = value * 10 + (str[i] - '0');
+  }
+  if (negative) {
+    return value > ((uint64_t)1 << 63) ? SK_PARSE_INVALID : 0 - value;
+  }
+  return value >= ((uint64_t)1 << 63) ? SK_PARSE_INVALID : value;
+}
+
+static const char sk_digit_pairs[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+char* SKIP_Int_toString(SkipInt n) {
+  char buffer[20];
+  char* end = buffer + sizeof(buffer);
+  char* p = end;
+  int negative = (int64_t)n < 0;
+  uint64_t value = negative ? 0 - n : n;
+  while (value >= 100) {
+    p -= 2;
+    memcpy(p, sk_digit_pairs + 2 * (value % 100), 2);
+    value /= 100;
+  }
+  if (value >= 10) {
+    p -= 2;
+    memcpy(p, sk_digit_pairs + 2 * value, 2);
+  } else {
+    *--p = (char)('0' + value);
+  }
+  if (negative) {
+    *--p = '-';
+  }
+  return sk_string_create(p, (uint32_t)(end - p));
+}
+
+// The powers of ten that are exact doubles.
+static const double sk_exact_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+static double sk_parse_float_slow(unsigned char* str, uint32_t size) {
   if (size >= 255) {
     SKIP_throw_cruntime(ERROR_FLOAT_TOO_LARGE);
   }
   char cstr[256];
   memcpy(cstr, str, size);
   cstr[size] = 0;
-
   return atof(cstr);
 }
 
+// Parses an optional '-', an integral part without leading zeros, and an
+// optional fractional part and exponent, at least one of which must be
+// present. Returns nan when the string is not a valid Float.
+//
+// Values with at most 15 significant digits and a small decimal exponent
+// are computed exactly with a single multiplication or division by an
+// exact power of ten (Clinger's fast path), which covers the vast majority
+// of numbers found in text; the others are left to atof().
+double SKIP_String_parseFloat(unsigned char* str) {
+  uint32_t size = SKIP_String_byteSize((char*)str);
+  uint32_t i = 0;
+  int negative = 0;
+  uint64_t mantissa = 0;
+  int digits = 0;
+  int64_t exponent = 0;
+  int has_fraction_or_exponent = 0;
+
+  if (i < size && str[i] == '-') {
+    negative = 1;
+    i++;
+  }
+  if (i < size && str[i] == '0') {
+    i++;
+  } else if (i < size && sk_is_digit(str[i])) {
+    for (; i < size && sk_is_digit(str[i]); i++) {
+      if (digits < 19) {
+        mantissa = mantissa * 10 + (str[i] - '0');
+      }
+      digits++;
+    }
+  } else {
+    return __builtin_nan("");
+  }
+  if (i < size && str[i] == '.') {
+    has_fraction_or_exponent = 1;
+    for (i++; i < size && sk_is_digit(str[i]); i++) {
+      if (digits == 0 && str[i] == '0') {
+        exponent--;
+        continue;
+      }
+      if (digits < 19) {
+        mantissa = mantissa * 10 + (str[i] - '0');
+        exponent--;
+      }
+      digits++;
+    }
+  }
+  if (i < size && (str[i] == 'e' || str[i] == 'E')) {
+    has_fraction_or_exponent = 1;
+    int exponent_negative = 0;
+    int64_t value = 0;
+    i++;
+    if (i < size && (str[i] == '-' || str[i] == '+')) {
+      exponent_negative = str[i] == '-';
+      i++;
+    }
+    if (i == size) {
+      return __builtin_nan("");
+    }
+    for (; i < size && sk_is_digit(str[i]); i++) {
+      if (value < 100000) {
+        value = value * 10 + (str[i] - '0');
+      }
+    }
+    exponent += exponent_negative ? -value : value;
+  }
+  if (i != size || !has_fraction_or_exponent) {
+    return __builtin_nan("");
+  }
+
+  double result;
+  if (mantissa == 0) {
+    result = 0.0;
+  } else if (digits <= 15 && exponent >= -22 && exponent <= 22) {
+    result = (double)mantissa;
+    if (exponent < 0) {
+      result /= sk_exact_pow10[-exponent];
+    } else {
+      result *= sk_exact_pow10[exponent];
+    }
+  } else {
+    return sk_parse_float_slow(str, size);
+  }
+  return negative ? -result : result;
+}
+
 void* SKIP_Unsafe_string_ptr(char* str, int64_t offset) {
   return str + offset;
 }
 
+/*****************************************************************************/
+/* JSON string escaping. */
+/*****************************************************************************/
+
+// Bytes that cannot be copied verbatim into a JSON string literal: control
+// characters, '"', '\\', DEL, and (since the output is kept ASCII) every
+// byte of a multibyte character.
+static int sk_json_requires_escape(unsigned char c) {
+  return c < 0x20 || c == '"' || c == '\\' || c >= 0x7F;
+}
+
+// Returns the offset of the first byte at or after `i` that requires
+// escaping, or `size`. Eight bytes are tested at a time: each term below
+// has a high bit set in some byte iff the word contains a byte of the
+// corresponding class.
+static uint32_t sk_json_scan(const unsigned char* str, uint32_t i,
+                             uint32_t size) {
+  const uint64_t ones = 0x0101010101010101ULL;
+  const uint64_t highs = 0x8080808080808080ULL;
+  for (; i + 8 <= size; i += 8) {
+    uint64_t x;
+    memcpy(&x, str + i, 8);
+    uint64_t quote = x ^ (ones * '"');
+    uint64_t backslash = x ^ (ones * '\\');
+    uint64_t del = x ^ (ones * 0x7F);
+    uint64_t hits = ((x - ones * 0x20) & ~x) | ((quote - ones) & ~quote) |
+                    ((backslash - ones) & ~backslash) | ((del - ones) & ~del) |
+                    x;
+    if ((hits & highs) != 0) {
+      break;
+    }
+  }
+  while (i < size && !sk_json_requires_escape(str[i])) {
+    i++;
+  }
+  return i;
+}
+
+// Decodes the character starting at str[*i] and advances *i past it.
+static uint32_t sk_json_decode_utf8(const unsigned char* str, uint32_t* i,
+                                    uint32_t size) {
+  unsigned char c = str[*i];
+  uint32_t code;
+  uint32_t len;
+  if (c < 0x80) {
+    code = c;
+    len = 1;
+  } else if (c < 0xE0) {
+    code = c & 0x1F;
+    len = 2;
+  } else if (c < 0xF0) {
+    code = c & 0x0F;
+    len = 3;
+  } else {
+    code = c & 0x07;
+    len = 4;
+  }
+  if (*i + len > size) {
+    len = size - *i;
+  }
+  for (uint32_t k = 1; k < len; k++) {
+    code = (code << 6) | (str[*i + k] & 0x3F);
+  }
+  *i += len;
+  return code;
+}
+
+static const char sk_json_hex_digits[] = "0123456789abcdef";
+
+// Writes the escape sequence of `code` to `out` if it is not NULL, and
+// returns its length.
+static uint32_t sk_json_escape_char(uint32_t code, char* out) {
+  char short_form = 0;
+  switch (code) {
+    case '"':
+      short_form = '"';
+      break;
+    case '\\':
+      short_form = '\\';
+      break;
+    case '\b':
+      short_form = 'b';
+      break;
+    case '\f':
+      short_form = 'f';
+      break;
+    case '\n':
+      short_form = 'n';
+      break;
+    case '\r':
+      short_form = 'r';
+      break;
+    case '\t':
+      short_form = 't';
+      break;
+  }
+  if (short_form != 0) {
+    if (out != NULL) {
+      out[0] = '\\';
+      out[1] = short_form;
+    }
+    return 2;
+  }
+  uint32_t units[2];
+  uint32_t count = 1;
+  if (code < 0x10000) {
+    units[0] = code;
+  } else {
+    code -= 0x10000;
+    units[0] = 0xD800 + (code >> 10);
+    units[1] = 0xDC00 + (code & 0x3FF);
+    count = 2;
+  }
+  if (out != NULL) {
+    for (uint32_t u = 0; u < count; u++) {
+      char* dst = out + u * 6;
+      dst[0] = '\\';
+      dst[1] = 'u';
+      for (int d = 0; d < 4; d++) {
+        dst[2 + d] = sk_json_hex_digits[(units[u] >> (12 - 4 * d)) & 0xF];
+      }
+    }
+  }
+  return count * 6;
+}
+
+// Returns the contents of a JSON string literal for `str`, without the
+// quotes. The common case of a string without anything to escape returns
+// `str` itself; otherwise, the output is sized in a first pass and filled
+// in a second one.
+char* SKIP_json_escape(unsigned char* str) {
+  uint32_t size = SKIP_String_byteSize((char*)str);
+  uint32_t i = sk_json_scan(str, 0, size);
+  if (i == size) {
+    return (char*)str;
+  }
+  uint32_t result_size = i;
+  while (i < size) {
+    uint32_t code = sk_json_decode_utf8(str, &i, size);
+    result_size += sk_json_escape_char(code, NULL);
+    uint32_t next = sk_json_scan(str, i, size);
+    result_size += next - i;
+    i = next;
+  }
+  char* result = sk_string_alloc(result_size);
+  char* out = result;
+  i = 0;
+  while (i < size) {
+    uint32_t next = sk_json_scan(str, i, size);
+    memcpy(out, str + i, next - i);
+    out += next - i;
+    i = next;
+    if (i < size) {
+      uint32_t code = sk_json_decode_utf8(str, &i, size);
+      out += sk_json_escape_char(code, out);
+    }
+  }
+  sk_string_set_hash(result);
+  return result;
+}
+
 /*****************************************************************************/
 /* Multibyte utf8 string used for testing purposes. */
 /*****************************************************************************/
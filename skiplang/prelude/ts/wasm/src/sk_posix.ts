@@ -85,7 +85,7 @@ class LinksImpl implements Links, ToWasm {
       // TODO: Write bytes directly into fs.
       this.fs.write(
         fd,
-        new TextDecoder().decode(utils.importBytes2(skContents, len)),
+        new TextDecoder().decode(utils.borrowBytes(skContents, len)),
       );
       return len;
     };
@@ -96,7 +96,7 @@ class LinksImpl implements Links, ToWasm {
     ) => {
       const res = this.fs.read(fd, len);
       if (res !== null) {
-        utils.exportBytes2(new TextEncoder().encode(res), skContents);
+        utils.exportUTF8Into(res, skContents, len);
       }
       return len;
     };
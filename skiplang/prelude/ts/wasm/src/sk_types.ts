@@ -175,6 +175,10 @@ interface Exported {
     addr: ptr<Internal.Raw>,
     size: int,
   ) => ptr<Internal.String>;
+  sk_string_alloc: (size: int) => ptr<Internal.String>;
+  sk_string_set_hash: (strPtr: ptr<Internal.String>) => void;
+  sk_string_alloc_n: (sizes: ptr<Internal.Raw>, count: int) => void;
+  sk_string_set_hash_n: (strPtrs: ptr<Internal.Raw>, count: int) => void;
   SKIP_createByteArray: (size: int) => ptr<Internal.Array<Internal.Byte>>;
   SKIP_createFloatArray: (size: int) => ptr<Internal.Array<Internal.Float>>;
   SKIP_createUInt32Array: (size: int) => ptr<Internal.Array<Internal.UInt32>>;
@@ -203,8 +207,41 @@ export interface WasmSupplier {
   completeWasm: (wasm: object, utils: Utils) => void;
 }
 
+const encoder = new TextEncoder();
+
 function utf8Encode(str: string): Uint8Array {
-  return new TextEncoder().encode(str);
+  return encoder.encode(str);
+}
+
+// Strings up to this size are converted one character at a time when they
+// are ASCII, which is cheaper than a call to TextEncoder or TextDecoder.
+const smallString = 32;
+
+// The size of the UTF-8 encoding of a string, so that it can be written
+// directly into an exact-size Skip string. A lone low surrogate takes three
+// bytes, like the U+FFFD that TextEncoder writes in its place.
+function utf8Length(s: string): number {
+  let size = s.length;
+  for (let i = 0; i < s.length; i++) {
+    const c = s.charCodeAt(i);
+    if (c < 0x80) continue;
+    if (c < 0x800) {
+      size += 1;
+    } else if (c < 0xd800 || c > 0xdbff) {
+      size += 2;
+    } else {
+      if (++i >= s.length)
+        throw new Error("UTF-8 encode: incomplete surrogate pair");
+      const c2 = s.charCodeAt(i);
+      if (c2 < 0xdc00 || c2 > 0xdfff)
+        throw new Error(
+          `UTF-8 encode: second surrogate character 0x${c2.toString(16)} at index ${i} out of range`,
+        );
+      // Two UTF-16 code units for four bytes.
+      size += 2;
+    }
+  }
+  return size;
 }
 
 export type Main = (new_args: string[], new_stdin: string) => string;
@@ -372,54 +409,64 @@ export class Utils {
   importString = (strPtr: ptr<Internal.String>) => {
     const size = this.exports.SKIP_String_byteSize(strPtr);
     const utf8 = new Uint8Array(this.exports.memory.buffer, strPtr, size);
+    if (size <= smallString) {
+      let str = "";
+      for (let i = 0; i < size; i++) {
+        const c = utf8[i]!;
+        if (c >= 0x80) return this.env.decodeUTF8(utf8);
+        str += String.fromCharCode(c);
+      }
+      return str;
+    }
     return this.env.decodeUTF8(utf8);
   };
   exportString = (s: string): ptr<Internal.String> => {
-    const data = new Uint8Array(this.exports.memory.buffer);
-    let i = 0;
-    const addr = this.exports.SKIP_Obstack_alloc(s.length * 4);
-    for (let ci = 0; ci != s.length; ci++) {
-      let c = s.charCodeAt(ci);
-      if (c < 128) {
-        data[addr + i++] = c;
-        continue;
-      }
-      if (c < 2048) {
-        data[addr + i++] = (c >> 6) | 192;
-      } else {
-        if (c > 0xd7ff && c < 0xdc00) {
-          if (++ci >= s.length)
-            throw new Error("UTF-8 encode: incomplete surrogate pair");
-          const c2 = s.charCodeAt(ci);
-          if (c2 < 0xdc00 || c2 > 0xdfff)
-            throw new Error(
-              `UTF-8 encode: second surrogate character 0x${c2.toString(16)} at index ${ci} out of range`,
-            );
-          c = 0x10000 + ((c & 0x03ff) << 10) + (c2 & 0x03ff);
-          data[addr + i++] = (c >> 18) | 240;
-          data[addr + i++] = ((c >> 12) & 63) | 128;
-        } else data[addr + i++] = (c >> 12) | 224;
-        data[addr + i++] = ((c >> 6) & 63) | 128;
-      }
-      data[addr + i++] = (c & 63) | 128;
+    const size = utf8Length(s);
+    const strPtr = this.exports.sk_string_alloc(size);
+    this.writeUTF8(s, strPtr, size);
+    this.exports.sk_string_set_hash(strPtr);
+    return strPtr;
+  };
+  // Exports several strings with a single allocation call and a single
+  // hashing call into the runtime.
+  exportStrings = (strings: string[]): ptr<Internal.String>[] => {
+    const count = strings.length;
+    if (count == 0) return [];
+    const sizes = strings.map(utf8Length);
+    const table = this.exports.SKIP_Obstack_alloc(count * 4);
+    new Uint32Array(this.exports.memory.buffer, table, count).set(sizes);
+    this.exports.sk_string_alloc_n(table, count);
+    const strPtrs = Array.from(
+      new Uint32Array(this.exports.memory.buffer, table, count),
+    ) as ptr<Internal.String>[];
+    for (let i = 0; i < count; i++) {
+      this.writeUTF8(strings[i]!, strPtrs[i]!, sizes[i]!);
+    }
+    this.exports.sk_string_set_hash_n(table, count);
+    return strPtrs;
+  };
+  private writeUTF8 = (s: string, addr: ptr<Internal.T<any>>, size: int) => {
+    const data = new Uint8Array(this.exports.memory.buffer, addr, size);
+    if (size == s.length && size <= smallString) {
+      for (let i = 0; i < size; i++) data[i] = s.charCodeAt(i);
+    } else {
+      encoder.encodeInto(s, data);
     }
-    return this.exports.sk_string_create(addr, i);
   };
   importBytes = (
     skArray: ptr<Internal.Array<Internal.Byte>>,
     sizeof: int = 1,
   ) => {
     const size = this.exports.SKIP_getArraySize(skArray) * sizeof;
-    const skData = new Uint8Array(this.exports.memory.buffer, skArray, size);
-    const copy = new Uint8Array(size);
-    copy.set(skData);
-    return copy;
+    return new Uint8Array(this.exports.memory.buffer, skArray, size).slice();
   };
   importBytes2 = (skBytes: ptr<Internal.T<any>>, size: int = 1) => {
-    const skData = new Uint8Array(this.exports.memory.buffer, skBytes, size);
-    const copy = new Uint8Array(size);
-    copy.set(skData);
-    return copy;
+    return new Uint8Array(this.exports.memory.buffer, skBytes, size).slice();
+  };
+  // A view of Skip memory, without copying: it is only valid until control
+  // returns to Skip code, which may free or reuse the memory.
+  borrowBytes = (skBytes: ptr<Internal.T<any>>, size: int) => {
+    return new Uint8Array(this.exports.memory.buffer, skBytes, size);
   };
   exportBytes = (view: Uint8Array) => {
     const skArray = this.exports.SKIP_createByteArray(view.byteLength);
@@ -439,6 +486,12 @@ export class Utils {
     );
     data.set(view);
   };
+  // Writes the UTF-8 encoding of a string into Skip memory, truncated to
+  // `size` bytes, and returns the number of bytes written.
+  exportUTF8Into = (s: string, skBytes: ptr<Internal.T<any>>, size: int) => {
+    const data = new Uint8Array(this.exports.memory.buffer, skBytes, size);
+    return encoder.encodeInto(s, data).written;
+  };
   importUInt32s = (skArray: ptr<Internal.Array<Internal.UInt32>>) => {
     const size = this.exports.SKIP_getArraySize(skArray);
     const skData = new Uint32Array(this.exports.memory.buffer, skArray, size);
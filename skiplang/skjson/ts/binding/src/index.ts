@@ -84,6 +84,9 @@ export function checkOrCloneParam<T>(value: T): T {
   if (typeof value == "object") {
     if (value === null) return value;
     if (isObjectProxy(value)) return value.clone() as T;
+    // Arrays imported from the runtime, unlike deep-frozen ones, may read
+    // their elements from the heap of the current call.
+    if (Array.isArray(value) && !Object.isFrozen(value)) return clone(value);
     if (isSkManaged(value)) return value;
     throw new Error("Invalid object: must be deep-frozen.");
   }
@@ -262,10 +265,13 @@ function interpretPointer<T extends Internal.CJSON>(
     case Type.Array: {
       const aPtr = binding.SKIP_SKJSON_asArray(pointer);
       const length = binding.SKIP_SKJSON_arraySize(aPtr);
-      const array = Array.from({ length }, (_, idx) =>
-        interpretPointer(binding, binding.SKIP_SKJSON_at(aPtr, idx)),
-      );
-      return tagSkManaged(array);
+      if (length <= eagerArraySize) {
+        const array = Array.from({ length }, (_, idx) =>
+          interpretPointer(binding, binding.SKIP_SKJSON_at(aPtr, idx)),
+        );
+        return tagSkManaged(array);
+      }
+      return lazyArray(binding, aPtr, length);
     }
     case Type.Object: {
       const oPtr = binding.SKIP_SKJSON_asObject(pointer);
@@ -280,8 +286,117 @@ function interpretPointer<T extends Internal.CJSON>(
   }
 }
 
+// Arrays up to this size are converted when imported, larger ones as their
+// elements are accessed.
+const eagerArraySize = 8;
+
+/**
+ * Proxy handler of imported arrays, converting their elements on access.
+ *
+ * The target is a sparse array of the right length, filled in as elements are
+ * read. Indices are reported present whether converted or not, so that array
+ * methods and iteration see every element. Operations on the whole array, or
+ * modifying it, first convert all remaining elements.
+ */
+class LazyArray implements ProxyHandler<Exportable[]> {
+  constructor(
+    private readonly binding: Binding,
+    private readonly pointer: Pointer<Internal.CJArray>,
+    private remaining: number,
+  ) {}
+
+  private index(target: Exportable[], prop: string | symbol): number | null {
+    if (typeof prop !== "string") return null;
+    const idx = Number(prop);
+    if (!Number.isInteger(idx) || idx < 0 || idx >= target.length) return null;
+    return String(idx) === prop ? idx : null;
+  }
+
+  private load(target: Exportable[], idx: number): void {
+    if (idx in target) return;
+    target[idx] = interpretPointer(
+      this.binding,
+      this.binding.SKIP_SKJSON_at(this.pointer, idx),
+    );
+    this.remaining--;
+  }
+
+  loadAll(target: Exportable[]): void {
+    for (let idx = 0; this.remaining > 0 && idx < target.length; idx++) {
+      this.load(target, idx);
+    }
+  }
+
+  get(target: Exportable[], prop: string | symbol, receiver: any): any {
+    const idx = this.index(target, prop);
+    if (idx !== null) this.load(target, idx);
+    return Reflect.get(target, prop, receiver);
+  }
+
+  has(target: Exportable[], prop: string | symbol): boolean {
+    return this.index(target, prop) !== null || Reflect.has(target, prop);
+  }
+
+  ownKeys(target: Exportable[]): (string | symbol)[] {
+    this.loadAll(target);
+    return Reflect.ownKeys(target);
+  }
+
+  getOwnPropertyDescriptor(
+    target: Exportable[],
+    prop: string | symbol,
+  ): PropertyDescriptor | undefined {
+    const idx = this.index(target, prop);
+    if (idx !== null) this.load(target, idx);
+    return Reflect.getOwnPropertyDescriptor(target, prop);
+  }
+
+  set(
+    target: Exportable[],
+    prop: string | symbol,
+    value: any,
+    receiver: any,
+  ): boolean {
+    this.loadAll(target);
+    return Reflect.set(target, prop, value, receiver);
+  }
+
+  defineProperty(
+    target: Exportable[],
+    prop: string | symbol,
+    descriptor: PropertyDescriptor,
+  ): boolean {
+    this.loadAll(target);
+    return Reflect.defineProperty(target, prop, descriptor);
+  }
+
+  deleteProperty(target: Exportable[], prop: string | symbol): boolean {
+    this.loadAll(target);
+    return Reflect.deleteProperty(target, prop);
+  }
+}
+
+function lazyArray(
+  binding: Binding,
+  pointer: Pointer<Internal.CJArray>,
+  length: number,
+): readonly Exportable[] & Managed {
+  const handler = new LazyArray(binding, pointer, length);
+  const target = tagSkManaged(new Array<Exportable>(length));
+  // NodeJS' console.log shows the target of proxies
+  Object.defineProperty(target, Symbol.for("nodejs.util.inspect.custom"), {
+    value: () => {
+      handler.loadAll(target);
+      return Array.from(target);
+    },
+  });
+  return new Proxy(target, handler);
+}
+
 class ObjectHandle<T extends Internal.CJSON> {
   private fields?: Map<string, number>;
+  // Field values already imported, so that repeated accesses share them.
+  private readonly values = new Map<number, Exportable>();
 
   constructor(
     private readonly binding: Binding,
@@ -289,10 +404,13 @@ class ObjectHandle<T extends Internal.CJSON> {
   ) {}
 
   private getFieldAt(idx: number): Exportable {
-    return interpretPointer(
+    if (this.values.has(idx)) return this.values.get(idx);
+    const value = interpretPointer(
       this.binding,
       this.binding.SKIP_SKJSON_get(this.pointer, idx),
     );
+    this.values.set(idx, value);
+    return value;
   }
 
   private objectFields() {
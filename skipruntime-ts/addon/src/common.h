@@ -74,5 +74,6 @@ struct SkipException : std::exception {
 #define SKReducer void*
 #define SKMapper void*
 #define SKRequest void*
+#define SKJsonPattern void*
 
 #endif  // SKCOMMON_H
\ No newline at end of file
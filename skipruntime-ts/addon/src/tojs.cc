@@ -23,7 +23,9 @@ void SkipRuntime_ExternalServiceMap__add(SKExternalServiceMap services,
                                          char* name, SKExternalService service);
 
 char* SkipRuntime_Context__createLazyCollection(SKLazyCompute lazyCompute);
-CJArray SkipRuntime_Context__jsonExtract(CJObject json, char* pattern);
+CJArray SkipRuntime_Context__jsonExtract(CJObject json, SKJsonPattern pattern);
+SKJsonPattern SkipRuntime_Context__compileJsonPattern(char* pattern);
+void SkipRuntime_Context__dropJsonPattern(SKJsonPattern pattern);
 char* SkipRuntime_Context__useExternalResource(char* service, char* identifier,
                                                CJObject json);
 
@@ -64,12 +66,14 @@ double SkipRuntime_Runtime__createResource(char* identifier, char* resource,
                                            CJObject jsonParams);
 double SkipRuntime_Runtime__closeResource(char* identifier);
 int64_t SkipRuntime_Runtime__subscribe(char* reactiveId, SKNotifier notifier,
-                                       char* watermark);
+                                       char* watermark, CJArray ranges);
 double SkipRuntime_Runtime__unsubscribe(int64_t id);
 CJSON SkipRuntime_Runtime__getAll(char* resource, CJObject jsonParams,
                                   SKRequest optRequest);
 CJSON SkipRuntime_Runtime__getForKey(char* resource, CJObject jsonParams,
                                      CJSON key, SKRequest optRequest);
+CJSON SkipRuntime_Runtime__getForKeys(char* resource, CJObject jsonParams,
+                                      CJArray keys, SKRequest optRequest);
 double SkipRuntime_Runtime__update(char* input, CJSON values);
 }
 
@@ -290,19 +294,59 @@ void JSONExtractOfContext(const FunctionCallbackInfo<Value>& args) {
         FromUtf8(isolate, "The first parameter must be a pointer.")));
     return;
   }
-  if (!args[1]->IsString()) {
+  if (!args[1]->IsExternal()) {
     isolate->ThrowException(Exception::TypeError(
-        FromUtf8(isolate, "The second parameter must be a string.")));
+        FromUtf8(isolate, "The second parameter must be a pointer.")));
     return;
   }
   NatTryCatch(isolate, [&args](Isolate* isolate) {
-    CJArray skResult = SkipRuntime_Context__jsonExtract(
-        args[0].As<External>()->Value(),
-        ToSKString(isolate, args[1].As<String>()));
+    CJArray skResult =
+        SkipRuntime_Context__jsonExtract(args[0].As<External>()->Value(),
+                                         args[1].As<External>()->Value());
     args.GetReturnValue().Set(External::New(isolate, skResult));
   });
 }
 
+void CompileJsonPatternOfContext(const FunctionCallbackInfo<Value>& args) {
+  Isolate* isolate = args.GetIsolate();
+  if (args.Length() != 1) {
+    // Throw an Error that is passed back to JavaScript
+    isolate->ThrowException(
+        Exception::TypeError(FromUtf8(isolate, "Must have one parameters.")));
+    return;
+  };
+  if (!args[0]->IsString()) {
+    // Throw an Error that is passed back to JavaScript
+    isolate->ThrowException(Exception::TypeError(
+        FromUtf8(isolate, "The parameter must be a string.")));
+    return;
+  }
+  NatTryCatch(isolate, [&args](Isolate* isolate) {
+    SKJsonPattern skResult = SkipRuntime_Context__compileJsonPattern(
+        ToSKString(isolate, args[0].As<String>()));
+    args.GetReturnValue().Set(External::New(isolate, skResult));
+  });
+}
+
+void DropJsonPatternOfContext(const FunctionCallbackInfo<Value>& args) {
+  Isolate* isolate = args.GetIsolate();
+  if (args.Length() != 1) {
+    // Throw an Error that is passed back to JavaScript
+    isolate->ThrowException(
+        Exception::TypeError(FromUtf8(isolate, "Must have one parameters.")));
+    return;
+  };
+  if (!args[0]->IsExternal()) {
+    // Throw an Error that is passed back to JavaScript
+    isolate->ThrowException(Exception::TypeError(
+        FromUtf8(isolate, "The parameter must be a pointer.")));
+    return;
+  }
+  NatTryCatch(isolate, [&args](Isolate* isolate) {
+    SkipRuntime_Context__dropJsonPattern(args[0].As<External>()->Value());
+  });
+}
+
 void UseExternalResourceOfContext(const FunctionCallbackInfo<Value>& args) {
   Isolate* isolate = args.GetIsolate();
   if (args.Length() != 3) {
@@ -986,6 +1030,12 @@ void SubscribeOfRuntime(const FunctionCallbackInfo<Value>& args) {
         isolate, "The third parameter must be a string or undefined.")));
     return;
   };
+  if (!args[3]->IsExternal() && !args[3]->IsNull() && !args[3]->IsUndefined()) {
+    // Throw an Error that is passed back to JavaScript
+    isolate->ThrowException(Exception::TypeError(FromUtf8(
+        isolate, "The fourth parameter must be a pointer or undefined.")));
+    return;
+  };
   NatTryCatch(isolate, [&args](Isolate* isolate) {
     char* skidentifier = ToSKString(isolate, args[0].As<String>());
     SKNotifier sknotifier = args[1].As<External>()->Value();
@@ -993,8 +1043,12 @@ void SubscribeOfRuntime(const FunctionCallbackInfo<Value>& args) {
     if (args[2]->IsString()) {
       skwatermark = ToSKString(isolate, args[2].As<String>());
     }
-    int64_t session =
-        SkipRuntime_Runtime__subscribe(skidentifier, sknotifier, skwatermark);
+    CJArray skranges = nullptr;
+    if (args[3]->IsExternal()) {
+      skranges = args[3].As<External>()->Value();
+    }
+    int64_t session = SkipRuntime_Runtime__subscribe(skidentifier, sknotifier,
+                                                     skwatermark, skranges);
     args.GetReturnValue().Set(BigInt::New(isolate, session));
   });
 }
@@ -1066,6 +1120,40 @@ void GetForKeyOfRuntime(const FunctionCallbackInfo<Value>& args) {
   });
 }
 
+void GetForKeysOfRuntime(const FunctionCallbackInfo<Value>& args) {
+  Isolate* isolate = args.GetIsolate();
+  if (!args[0]->IsString()) {
+    // Throw an Error that is passed back to JavaScript
+    isolate->ThrowException(Exception::TypeError(
+        FromUtf8(isolate, "The first parameter must be a string.")));
+    return;
+  }
+  if (!args[1]->IsExternal() || !args[2]->IsExternal()) {
+    // Throw an Error that is passed back to JavaScript
+    isolate->ThrowException(Exception::TypeError(FromUtf8(
+        isolate, "The second and third parameters must be pointers.")));
+    return;
+  }
+  if (!args[3]->IsExternal() && !args[3]->IsNull() && !args[3]->IsUndefined()) {
+    // Throw an Error that is passed back to JavaScript
+    isolate->ThrowException(Exception::TypeError(FromUtf8(
+        isolate, "The fourth parameter must be a pointer or undefined.")));
+    return;
+  };
+  NatTryCatch(isolate, [&args](Isolate* isolate) {
+    char* skresource = ToSKString(isolate, args[0].As<String>());
+    CJObject skparams = args[1].As<External>()->Value();
+    CJArray skkeys = args[2].As<External>()->Value();
+    SKRequest skrequest = nullptr;
+    if (args[3]->IsExternal()) {
+      skrequest = args[3].As<External>()->Value();
+    }
+    CJSON skresult = SkipRuntime_Runtime__getForKeys(skresource, skparams,
+                                                     skkeys, skrequest);
+    args.GetReturnValue().Set(External::New(isolate, skresult));
+  });
+}
+
 void UpdateOfRuntime(const FunctionCallbackInfo<Value>& args) {
   Isolate* isolate = args.GetIsolate();
   if (!args[0]->IsString()) {
@@ -1112,6 +1200,10 @@ void GetToJSBinding(const FunctionCallbackInfo<Value>& args) {
               CreateLazyCollectionOfContext);
   AddFunction(isolate, binding, "SkipRuntime_Context__jsonExtract",
               JSONExtractOfContext);
+  AddFunction(isolate, binding, "SkipRuntime_Context__compileJsonPattern",
+              CompileJsonPatternOfContext);
+  AddFunction(isolate, binding, "SkipRuntime_Context__dropJsonPattern",
+              DropJsonPatternOfContext);
   AddFunction(isolate, binding, "SkipRuntime_Context__useExternalResource",
               UseExternalResourceOfContext);
   //
@@ -1171,6 +1263,8 @@ void GetToJSBinding(const FunctionCallbackInfo<Value>& args) {
   AddFunction(isolate, binding, "SkipRuntime_Runtime__getAll", GetAllOfRuntime);
   AddFunction(isolate, binding, "SkipRuntime_Runtime__getForKey",
               GetForKeyOfRuntime);
+  AddFunction(isolate, binding, "SkipRuntime_Runtime__getForKeys",
+              GetForKeysOfRuntime);
   AddFunction(isolate, binding, "SkipRuntime_Runtime__update", UpdateOfRuntime);
 
   args.GetReturnValue().Set(binding);
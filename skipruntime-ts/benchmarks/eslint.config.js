@@ -0,0 +1,3 @@
+import config from "@skiplabs/eslint-config";
+
+export default [...config];
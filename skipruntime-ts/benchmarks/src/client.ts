@@ -0,0 +1,92 @@
+import type { Entry, Json } from "@skipruntime/core";
+
+/**
+ * Send a JSON request to a Skip service, failing on error responses.
+ */
+export async function request(
+  method: "POST" | "PATCH",
+  url: string,
+  body: Json,
+): Promise<Response> {
+  const response = await fetch(url, {
+    method,
+    headers: { "Content-Type": "application/json" },
+    body: JSON.stringify(body),
+  });
+  if (!response.ok) {
+    throw new Error(`${method} ${url}: ${response.status.toString()}`);
+  }
+  return response;
+}
+
+/**
+ * Subscription to a resource instance through the streaming API.
+ *
+ * Events are parsed as they arrive, and `onEvent` is called with the time
+ * they were received, from `performance.now()`.
+ */
+export class Subscriber {
+  private readonly abort = new AbortController();
+  /**
+   * Resolves once the `init` event was received.
+   */
+  readonly initialized: Promise<void>;
+
+  constructor(
+    url: string,
+    onEvent: (
+      event: "init" | "update",
+      values: Entry<Json, Json>[],
+      receivedAt: number,
+    ) => void,
+  ) {
+    this.initialized = new Promise((resolve, reject) => {
+      this.read(url, (event, values, receivedAt) => {
+        if (event == "init") resolve();
+        onEvent(event, values, receivedAt);
+      }).catch((e: unknown) => {
+        if (!this.abort.signal.aborted) reject(e as Error);
+      });
+    });
+  }
+
+  close(): void {
+    this.abort.abort();
+  }
+
+  private async read(
+    url: string,
+    onEvent: (
+      event: "init" | "update",
+      values: Entry<Json, Json>[],
+      receivedAt: number,
+    ) => void,
+  ): Promise<void> {
+    const response = await fetch(url, {
+      headers: { Accept: "text/event-stream" },
+      signal: this.abort.signal,
+    });
+    if (!response.ok || !response.body) {
+      throw new Error(`GET ${url}: ${response.status.toString()}`);
+    }
+    const decoder = new TextDecoder();
+    let buffer = "";
+    for await (const chunk of response.body) {
+      const receivedAt = performance.now();
+      buffer += decoder.decode(chunk, { stream: true });
+      let end;
+      while ((end = buffer.indexOf("\n\n")) >= 0) {
+        let event = "message";
+        let data = "";
+        for (const line of buffer.slice(0, end).split("\n")) {
+          if (line.startsWith("event: ")) event = line.slice(7);
+          else if (line.startsWith("data: ")) data += line.slice(6);
+        }
+        buffer = buffer.slice(end + 2);
+        if (event == "init" || event == "update") {
+          onEvent(event, JSON.parse(data) as Entry<Json, Json>[], receivedAt);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,272 @@
+/**
+ * Load test of a Skip service run by `runService`, see `README.md`.
+ */
+
+import { fork } from "node:child_process";
+import type { ChildProcess } from "node:child_process";
+import { writeFileSync } from "node:fs";
+import { setTimeout as sleep } from "node:timers/promises";
+import { parseArgs } from "node:util";
+import type {
+  ServerMessage,
+  ServerOptions,
+  ServerRequest,
+  ServerStats,
+} from "./server.js";
+import { request, Subscriber } from "./client.js";
+import { summarize } from "./stats.js";
+import type { Summary } from "./stats.js";
+
+type Config = {
+  platforms: ("wasm" | "native")[];
+  subscribers: number;
+  rate: number;
+  duration: number;
+  keys: number;
+  snapshotClients: number;
+  workers: number;
+  coalesceMs: number;
+  port: number;
+};
+
+type Result = {
+  platform: "wasm" | "native";
+  updates: {
+    writes: number;
+    failedWrites: number;
+    // Updates of written keys received by subscribers.
+    received: number;
+    expected: number;
+    // From sending a write to receiving the update, over all subscribers.
+    latencyMs: Summary;
+  };
+  snapshots: {
+    requests: number;
+    failed: number;
+    perSecond: number;
+    latencyMs: Summary;
+  };
+  // Of the service process, over the update phase.
+  server: {
+    cpuMsPerWrite: number;
+    rssGrowthBytes: number;
+    heapGrowthBytes: number;
+    externalGrowthBytes: number;
+  };
+};
+
+const args = parseArgs({
+  options: {
+    platform: { type: "string", default: "wasm" },
+    subscribers: { type: "string", default: "10" },
+    rate: { type: "string", default: "100" },
+    duration: { type: "string", default: "10" },
+    keys: { type: "string", default: "100" },
+    "snapshot-clients": { type: "string", default: "8" },
+    workers: { type: "string", default: "0" },
+    "coalesce-ms": { type: "string", default: "0" },
+    port: { type: "string", default: "9587" },
+    output: { type: "string" },
+  },
+});
+
+const config: Config = {
+  platforms: args.values.platform.split(",").map((p) => {
+    if (p != "wasm" && p != "native") {
+      throw new Error(`Unknown platform ${p}`);
+    }
+    return p;
+  }),
+  subscribers: Number(args.values.subscribers),
+  rate: Number(args.values.rate),
+  duration: Number(args.values.duration),
+  keys: Number(args.values.keys),
+  snapshotClients: Number(args.values["snapshot-clients"]),
+  workers: Number(args.values.workers),
+  coalesceMs: Number(args.values["coalesce-ms"]),
+  port: Number(args.values.port),
+};
+
+class Server {
+  private readonly child: ChildProcess;
+  private readonly pending: ((stats: ServerStats) => void)[] = [];
+  readonly ready: Promise<void>;
+
+  constructor(options: ServerOptions) {
+    this.child = fork(
+      new URL("./server.js", import.meta.url),
+      [JSON.stringify(options)],
+      { stdio: ["ignore", "ignore", "inherit", "ipc"] },
+    );
+    this.ready = new Promise((resolve, reject) => {
+      this.child.once("exit", (code) => {
+        reject(new Error(`Service exited with code ${String(code)}`));
+      });
+      this.child.on("message", (msg: ServerMessage) => {
+        if (msg.kind == "ready") resolve();
+        else this.pending.shift()?.(msg.stats);
+      });
+    });
+  }
+
+  stats(): Promise<ServerStats> {
+    return new Promise((resolve) => {
+      this.pending.push(resolve);
+      this.send({ kind: "stats" });
+    });
+  }
+
+  close(): Promise<void> {
+    return new Promise((resolve) => {
+      this.child.removeAllListeners("exit");
+      this.child.once("exit", () => {
+        resolve();
+      });
+      this.send({ kind: "close" });
+    });
+  }
+
+  private send(msg: ServerRequest) {
+    this.child.send(msg);
+  }
+}
+
+async function run(platform: "wasm" | "native"): Promise<Result> {
+  const control = `http://localhost:${(config.port + 1).toString()}`;
+  const streaming = `http://localhost:${config.port.toString()}`;
+  const server = new Server({
+    control_port: config.port + 1,
+    streaming_port: config.port,
+    platform,
+    workers: config.workers,
+    coalesce_ms: config.coalesceMs,
+  });
+  await server.ready;
+
+  // Updates: writes of sequence numbers at a fixed rate, each received by
+  // every subscriber as the new value of the written key.
+  const sent = new Map<number, number>();
+  const latencies: number[] = [];
+  let received = 0;
+  const subscribers: Subscriber[] = [];
+  for (let i = 0; i < config.subscribers; i++) {
+    const uuid = await (
+      await request("POST", `${control}/v1/streams/sum`, {})
+    ).text();
+    subscribers.push(
+      new Subscriber(
+        `${streaming}/v1/streams/${uuid}`,
+        (_event, values, receivedAt) => {
+          for (const [, [seq]] of values) {
+            const sentAt = sent.get(seq as number);
+            if (sentAt === undefined) continue;
+            received++;
+            latencies.push(receivedAt - sentAt);
+          }
+        },
+      ),
+    );
+  }
+  await Promise.all(subscribers.map((s) => s.initialized));
+
+  const before = await server.stats();
+  let writes = 0;
+  let failedWrites = 0;
+  const writing: Promise<void>[] = [];
+  const start = performance.now();
+  const end = start + config.duration * 1000;
+  for (let seq = 1; ; seq++) {
+    const due = start + (seq * 1000) / config.rate;
+    if (due >= end) break;
+    const wait = due - performance.now();
+    if (wait > 0) await sleep(wait);
+    sent.set(seq, performance.now());
+    writes++;
+    writing.push(
+      request("PATCH", `${control}/v1/inputs/input`, [
+        [`key${(seq % config.keys).toString()}`, [seq]],
+      ]).then(
+        () => {},
+        () => {
+          failedWrites++;
+        },
+      ),
+    );
+  }
+  await Promise.all(writing);
+  // Let the last updates arrive.
+  await sleep(1000 + config.coalesceMs);
+  const after = await server.stats();
+  for (const subscriber of subscribers) subscriber.close();
+
+  // Snapshots: concurrent clients reading the resource back to back.
+  const snapshotLatencies: number[] = [];
+  let failed = 0;
+  const snapshotEnd = performance.now() + config.duration * 1000;
+  await Promise.all(
+    Array.from({ length: config.snapshotClients }, async () => {
+      while (performance.now() < snapshotEnd) {
+        const t = performance.now();
+        try {
+          await (
+            await request("POST", `${control}/v1/snapshot/sum`, {})
+          ).arrayBuffer();
+          snapshotLatencies.push(performance.now() - t);
+        } catch {
+          failed++;
+        }
+      }
+    }),
+  );
+
+  await server.close();
+
+  const cpuMs =
+    (after.cpu.user + after.cpu.system - before.cpu.user - before.cpu.system) /
+    1000;
+  return {
+    platform,
+    updates: {
+      writes,
+      failedWrites,
+      received,
+      expected: writes * config.subscribers,
+      latencyMs: summarize(latencies),
+    },
+    snapshots: {
+      requests: snapshotLatencies.length,
+      failed,
+      perSecond:
+        Math.round((snapshotLatencies.length / config.duration) * 10) / 10,
+      latencyMs: summarize(snapshotLatencies),
+    },
+    server: {
+      cpuMsPerWrite: Math.round((cpuMs / (writes || 1)) * 1000) / 1000,
+      rssGrowthBytes: after.memory.rss - before.memory.rss,
+      heapGrowthBytes: after.memory.heapUsed - before.memory.heapUsed,
+      externalGrowthBytes: after.memory.external - before.memory.external,
+    },
+  };
+}
+
+const results: Result[] = [];
+for (const platform of config.platforms) {
+  console.error(`Running on @skipruntime/${platform}...`);
+  results.push(await run(platform));
+}
+
+const report = JSON.stringify(
+  {
+    date: new Date().toISOString(),
+    node: process.version,
+    config,
+    results,
+  },
+  null,
+  2,
+);
+if (args.values.output) {
+  writeFileSync(args.values.output, report + "\n");
+} else {
+  console.log(report);
+}
@@ -0,0 +1,51 @@
+/**
+ * Benchmarked service, run in a child process of the benchmark so that its
+ * CPU time and memory are measured apart from the load generator's.
+ */
+
+import { runService } from "@skipruntime/server";
+import { service } from "./service.js";
+
+export type ServerOptions = {
+  control_port: number;
+  streaming_port: number;
+  platform: "wasm" | "native";
+  workers: number;
+  coalesce_ms: number;
+};
+
+export type ServerStats = {
+  cpu: NodeJS.CpuUsage;
+  memory: NodeJS.MemoryUsage;
+};
+
+export type ServerMessage =
+  | { kind: "ready" }
+  | { kind: "stats"; stats: ServerStats };
+
+export type ServerRequest = { kind: "stats" } | { kind: "close" };
+
+const options = JSON.parse(process.argv[2]!) as ServerOptions;
+const server = await runService(service, options);
+const send = (msg: ServerMessage) => process.send!(msg);
+
+process.on("message", (msg: ServerRequest) => {
+  switch (msg.kind) {
+    case "stats":
+      send({
+        kind: "stats",
+        stats: { cpu: process.cpuUsage(), memory: process.memoryUsage() },
+      });
+      break;
+    case "close":
+      server.close().then(
+        () => process.exit(0),
+        (e: unknown) => {
+          console.error(e);
+          process.exit(1);
+        },
+      );
+      break;
+  }
+});
+send({ kind: "ready" });
@@ -0,0 +1,32 @@
+import type {
+  EagerCollection,
+  Mapper,
+  Resource,
+  SkipService,
+  Values,
+} from "@skipruntime/core";
+
+// The `sum` example, over a single input collection: each write to `input`
+// is seen by the subscribers of `sum` as an update of the written key.
+
+type Collections = {
+  input: EagerCollection<string, number>;
+};
+
+class Plus implements Mapper<string, number, string, number> {
+  mapEntry(key: string, values: Values<number>): Iterable<[string, number]> {
+    return [[key, values.toArray().reduce((p, c) => p + c, 0)]];
+  }
+}
+
+class Sum implements Resource<Collections> {
+  instantiate(cs: Collections): EagerCollection<string, number> {
+    return cs.input.map(Plus);
+  }
+}
+
+export const service: SkipService<Collections, Collections> = {
+  initialData: { input: [] },
+  resources: { sum: Sum },
+  createGraph: (inputs: Collections) => inputs,
+};
@@ -0,0 +1,32 @@
+/**
+ * Distribution of a set of measurements.
+ */
+export type Summary = {
+  count: number;
+  mean: number;
+  p50: number;
+  p90: number;
+  p99: number;
+  max: number;
+};
+
+/**
+ * Summarize a set of measurements, rounded to the microsecond when they are
+ * durations in milliseconds.
+ */
+export function summarize(samples: number[]): Summary {
+  const sorted = Float64Array.from(samples).sort();
+  const round = (x: number) => Math.round(x * 1000) / 1000;
+  const at = (p: number) =>
+    sorted.length == 0
+      ? 0
+      : round(sorted[Math.min(sorted.length - 1, Math.floor(p * sorted.length))]!);
+  return {
+    count: sorted.length,
+    mean: round(sorted.reduce((s, x) => s + x, 0) / (sorted.length || 1)),
+    p50: at(0.5),
+    p90: at(0.9),
+    p99: at(0.99),
+    max: at(1),
+  };
+}
@@ -86,6 +86,8 @@ export interface Reducer<V extends Json, A extends Json> {
 
 /**
  * A non-empty iterable sequence of dependency-safe values.
+ *
+ * Values are imported from the runtime one at a time as they are iterated, and the arrays and objects among them convert their elements and fields as they are accessed, so that reading part of large values only pays for that part.
  */
 export interface Values<T> extends Iterable<T & DepSafe> {
   /**
@@ -363,7 +365,36 @@ export interface Context extends Managed {
     params?: Json;
   }): EagerCollection<K, V>;
 
-  jsonExtract(value: JsonObject, pattern: string): Json[];
+  /**
+   * Extract the parts of a JSON value matched by a pattern.
+   *
+   * Patterns given as strings are parsed on first use and kept for their next uses while they are among the most recently used ones.
+   *
+   * @param value - The value to match.
+   * @param pattern - The pattern, or a pattern compiled by `compileJsonPattern`.
+   * @returns The bindings of the pattern's variables, for each match.
+   */
+  jsonExtract(value: JsonObject, pattern: string | JsonPattern): Json[];
+
+  /**
+   * Parse a `jsonExtract` pattern once, to extract with it repeatedly.
+   *
+   * Mappers typically compile their patterns in their constructor, passing the `Context` as a parameter.
+   *
+   * @param pattern - The pattern.
+   * @returns The compiled pattern, kept for the lifetime of the service.
+   */
+  compileJsonPattern(pattern: string): JsonPattern;
+}
+
+/**
+ * A `jsonExtract` pattern compiled by `Context.compileJsonPattern`.
+ */
+export interface JsonPattern extends Managed {
+  /**
+   * The source of the pattern.
+   */
+  readonly pattern: string;
 }
 
 /**
@@ -403,6 +434,30 @@ export type CollectionUpdate<K extends Json, V extends Json> = {
   isInitial?: boolean;
 };
 
+/**
+ * Restriction of a subscription to part of a resource instance.
+ *
+ * Keys are selected by the runtime through the ordered keys of the collection, so that subscribers to few keys are not notified of, nor pay for, the others.
+ *
+ * @typeParam K - Type of keys.
+ */
+export type SubscriptionFilter<K extends Json = Json> = {
+  /**
+   * Keys to be notified of.
+   */
+  keys?: K[];
+
+  /**
+   * Inclusive range of keys to be notified of, in addition to `keys`.
+   */
+  range?: { start: K; end: K };
+
+  /**
+   * Fields to be notified of in object values, the other values being notified whole.
+   */
+  fields?: string[];
+};
+
 /**
  * Interface to an external service.
  *
@@ -26,6 +26,8 @@ export type Notifier<K extends Json, V extends Json> = {
   subscribed: () => void;
   notify: (update: CollectionUpdate<K, V>) => void;
   close: () => void;
+  // Fields of object values to import, all if undefined.
+  fields?: string[];
 };
 
 export interface Checker {
@@ -191,12 +193,20 @@ export interface FromBinding {
     request: Pointer<Internal.Request> | null,
   ): Pointer<Internal.CJObject | Internal.CJFloat>;
 
+  SkipRuntime_Runtime__getForKeys(
+    resource: string,
+    jsonParams: Pointer<Internal.CJObject>,
+    keys: Pointer<Internal.CJArray<Internal.CJSON>>,
+    request: Pointer<Internal.Request> | null,
+  ): Pointer<Internal.CJObject | Internal.CJFloat>;
+
   SkipRuntime_Runtime__closeResource(identifier: string): Handle<Error>;
 
   SkipRuntime_Runtime__subscribe(
     collection: string,
     notifier: Pointer<Internal.Notifier>,
     watermark: Nullable<string>,
+    ranges: Nullable<Pointer<Internal.CJArray>>,
   ): bigint;
 
   SkipRuntime_Runtime__unsubscribe(id: bigint): Handle<Error>;
@@ -227,9 +237,17 @@ export interface FromBinding {
 
   SkipRuntime_Context__jsonExtract(
     from: Pointer<Internal.CJObject>,
-    pattern: string,
+    pattern: Pointer<Internal.JsonPattern>,
   ): Pointer<Internal.CJArray>;
 
+  SkipRuntime_Context__compileJsonPattern(
+    pattern: string,
+  ): Pointer<Internal.JsonPattern>;
+
+  SkipRuntime_Context__dropJsonPattern(
+    pattern: Pointer<Internal.JsonPattern>,
+  ): void;
+
   SkipRuntime_Context__useExternalResource(
     service: string,
     identifier: string,
@@ -22,6 +22,12 @@ export class SkipUnknownResourceError extends SkipError {}
  */
 export class SkipRESTError extends SkipError {}
 
+/**
+ * Exception indicating a malformed frame in a binary stream of updates.
+ * @hideconstructor
+ */
+export class SkipProtocolError extends SkipError {}
+
 /**
  * Exception indicating that a fetch returned an HTTP status outside of the 200-299 range.
  * @hideconstructor
@@ -27,6 +27,7 @@ import {
   type EagerCollection,
   type Entry,
   type ExternalService,
+  type JsonPattern,
   type LazyCollection,
   type LazyCompute,
   type Mapper,
@@ -36,6 +37,7 @@ import {
   type Reducer,
   type Resource,
   type SkipService,
+  type SubscriptionFilter,
   type Watermark,
 } from "./api.js";
 
@@ -75,6 +77,33 @@ function instantiateUserObject<Params extends DepSafe[], Result extends object>(
   return obj;
 }
 
+// Copy of the entries keeping only the given fields of object values, read
+// from the lazily imported entries so that the other fields are never
+// converted. Fields are looked up as own properties: the `in` operator and
+// plain reads of an imported object also answer for its methods and
+// `__pointer`.
+function project<K extends Json, V extends Json>(
+  entries: Entry<K, V>[],
+  fields: string[],
+  skjson: JsonConverter,
+): Entry<K, V>[] {
+  return entries.map(([key, values]) => [
+    skjson.clone(key),
+    values.map((value) => {
+      if (typeof value != "object" || value === null || Array.isArray(value)) {
+        return skjson.clone(value);
+      }
+      const object = value as { [field: string]: Json | null };
+      const projected: { [field: string]: Json | null } = {};
+      for (const field of fields) {
+        const property = Object.getOwnPropertyDescriptor(object, field);
+        if (property) projected[field] = skjson.clone(property.value as Json);
+      }
+      return projected as V;
+    }),
+  ]);
+}
+
 class Handles {
   private nextID: number = 1;
   private readonly objects: any[] = [];
@@ -121,11 +150,54 @@ export class Stack {
   }
 }
 
+// The parsed patterns of `Context.jsonExtract`, by source. The runtime hands
+// them out of the reactive state, and they stay valid until dropped here.
+// Patterns used as strings are dropped once they are no longer among the
+// `capacity` most recently used ones (`recent` is in order of use, most
+// recent last); compiled patterns are kept.
+class JsonPatterns {
+  private readonly recent = new Map<string, Pointer<Internal.JsonPattern>>();
+  private readonly compiled = new Map<string, Pointer<Internal.JsonPattern>>();
+
+  constructor(
+    private readonly binding: FromBinding,
+    private readonly capacity: number = 256,
+  ) {}
+
+  get(pattern: string): Pointer<Internal.JsonPattern> {
+    const compiled = this.compiled.get(pattern);
+    if (compiled !== undefined) return compiled;
+    let parsed = this.recent.get(pattern);
+    if (parsed !== undefined) {
+      this.recent.delete(pattern);
+    } else {
+      parsed = this.binding.SkipRuntime_Context__compileJsonPattern(pattern);
+      if (this.recent.size >= this.capacity) {
+        const [oldest, dropped] = this.recent.entries().next().value!;
+        this.recent.delete(oldest);
+        this.binding.SkipRuntime_Context__dropJsonPattern(dropped);
+      }
+    }
+    this.recent.set(pattern, parsed);
+    return parsed;
+  }
+
+  compile(pattern: string): void {
+    if (this.compiled.has(pattern)) return;
+    const parsed =
+      this.recent.get(pattern) ??
+      this.binding.SkipRuntime_Context__compileJsonPattern(pattern);
+    this.recent.delete(pattern);
+    this.compiled.set(pattern, parsed);
+  }
+}
+
 export class Refs {
   constructor(
     public readonly binding: FromBinding,
     public readonly skjson: JsonConverter,
     public readonly handles: Handles,
+    public readonly jsonPatterns: JsonPatterns,
     public readonly needGC: () => boolean,
     public readonly runWithGC: <T>(fn: () => T) => T,
   ) {}
@@ -383,6 +455,13 @@ class CollectionWriter<K extends Json, V extends Json> {
   }
 }
 
+class JsonPatternImpl extends SkManaged implements JsonPattern {
+  constructor(public readonly pattern: string) {
+    super();
+    Object.freeze(this);
+  }
+}
+
 class ContextImpl extends SkManaged implements Context {
   constructor(private readonly refs: Refs) {
     super();
@@ -420,14 +499,22 @@ class ContextImpl extends SkManaged implements Context {
     return new EagerCollectionImpl<K, V>(collection, this.refs);
   }
 
-  jsonExtract(value: JsonObject, pattern: string): Json[] {
+  jsonExtract(value: JsonObject, pattern: string | JsonPattern): Json[] {
+    const parsed = this.refs.jsonPatterns.get(
+      typeof pattern == "string" ? pattern : pattern.pattern,
+    );
     return this.refs.skjson.importJSON(
       this.refs.binding.SkipRuntime_Context__jsonExtract(
         this.refs.skjson.exportJSON(value),
-        pattern,
+        parsed,
       ),
     ) as Json[];
   }
+
+  compileJsonPattern(pattern: string): JsonPattern {
+    this.refs.jsonPatterns.compile(pattern);
+    return new JsonPatternImpl(pattern);
+  }
 }
 
 export class ServiceInstanceFactory {
@@ -503,6 +590,34 @@ class OneChecker<K extends Json, V extends Json> implements Checker {
   }
 }
 
+class ManyChecker<K extends Json, V extends Json> implements Checker {
+  constructor(
+    private readonly service: ServiceInstance,
+    private readonly executor: Executor<V[][]>,
+    private readonly resource: string,
+    private readonly params: Json,
+    private readonly keys: K[],
+  ) {}
+
+  check(request: string): void {
+    try {
+      const result = this.service.getArrays<K, V>(
+        this.resource,
+        this.keys,
+        this.params,
+        request,
+      );
+      if (result.errors.length > 0) {
+        this.executor.reject(new Error(JSON.stringify(result.errors)));
+      } else {
+        this.executor.resolve(result.payload);
+      }
+    } catch (ex: unknown) {
+      this.executor.reject(ex);
+    }
+  }
+}
+
 export type SubscriptionID = Opaque<bigint, "subscription">;
 
 /**
@@ -607,6 +722,46 @@ export class ServiceInstance {
     return result as GetResult<V[]>;
   }
 
+  /**
+   * Get the current values of several keys in the specified resource instance, creating it if it doesn't already exist
+   *
+   * The keys are looked up together, in a single call into the runtime and with a single resource instance.
+   * @param resource - A resource name, which must correspond to a key in this `SkipService`'s `resources` field
+   * @param keys - The keys to look up in the resource instance
+   * @param params - Resource parameters, passed to the resource constructor specified in this `SkipService`'s `resources` field
+   * @returns The current value(s) of each key, in the order of `keys`
+   */
+  getArrays<K extends Json, V extends Json>(
+    resource: string,
+    keys: K[],
+    params: Json = {},
+    request?: string | Executor<V[][]>,
+  ): GetResult<V[][]> {
+    const get_ = () => {
+      return this.refs.skjson.importJSON(
+        this.refs.binding.SkipRuntime_Runtime__getForKeys(
+          resource,
+          this.refs.skjson.exportJSON(params),
+          this.refs.skjson.exportJSON(keys),
+          request !== undefined
+            ? typeof request == "string"
+              ? this.refs.binding.SkipRuntime_createIdentifier(request)
+              : this.refs.binding.SkipRuntime_createChecker(
+                  this.refs.handles.register(
+                    new ManyChecker(this, request, resource, params, keys),
+                  ),
+                )
+            : null,
+        ),
+        true,
+      );
+    };
+    const result = this.refs.needGC() ? this.refs.runWithGC(get_) : get_();
+    if (typeof result == "number")
+      throw this.refs.handles.deleteHandle(result as Handle<Error>);
+    return result as GetResult<V[][]>;
+  }
+
   /**
    * Close the specified resource instance
    * @param resourceInstanceId - The resource identifier
@@ -627,7 +782,8 @@ export class ServiceInstance {
    * @param notifier.subscribed - A callback to execute when subscription effectively done
    * @param notifier.notify - A callback to execute on collection updates
    * @param notifier.close - A callback to execute on resource close
-   * @param watermark - the watermark where to start the subscription
+   * @param watermark - the watermark where to start the subscription: the one of the last update received by a client resuming its subscription, in which case it is only notified of the changes since then if they are still retained, and of the whole collection otherwise
+   * @param filter - the keys and fields to be notified of, all if undefined
    * @returns A subscription identifier
    */
   subscribe<K extends Json, V extends Json>(
@@ -638,15 +794,29 @@ export class ServiceInstance {
       close: () => void;
     },
     watermark?: string,
+    filter?: SubscriptionFilter<K>,
   ): SubscriptionID {
+    const ranges: [K, K][] | null =
+      filter?.keys || filter?.range
+        ? (filter.keys ?? []).map((key): [K, K] => [key, key])
+        : null;
+    if (ranges && filter?.range) {
+      ranges.push([filter.range.start, filter.range.end]);
+    }
     const session = this.refs.runWithGC(() => {
       const sknotifier = this.refs.binding.SkipRuntime_createNotifier(
-        this.refs.handles.register(notifier),
+        this.refs.handles.register({
+          subscribed: notifier.subscribed,
+          notify: notifier.notify,
+          close: notifier.close,
+          fields: filter?.fields,
+        }),
       );
       return this.refs.binding.SkipRuntime_Runtime__subscribe(
         resourceInstanceId,
         sknotifier,
         watermark ?? null,
+        ranges ? this.refs.skjson.exportJSON(ranges) : null,
       );
     });
     if (session == -1n) {
@@ -794,6 +964,7 @@ class ValuesImpl<T> implements Values<T> {
 export class ToBinding {
   private readonly stack: Stack;
   private readonly handles: Handles;
+  private readonly jsonPatterns: JsonPatterns;
   private skjson?: JsonConverter;
 
   constructor(
@@ -804,6 +975,7 @@ export class ToBinding {
   ) {
     this.stack = new Stack();
     this.handles = new Handles();
+    this.jsonPatterns = new JsonPatterns(binding);
   }
 
   register<T>(v: T): Handle<T> {
@@ -965,7 +1137,13 @@ export class ToBinding {
   ) {
     const skjson = this.getJsonConverter();
     const notifier = this.handles.get(sknotifier);
-    const values = skjson.importJSON(skvalues, true) as Entry<K, V>[];
+    const values = notifier.fields
+      ? project(
+          skjson.importJSON(skvalues) as Entry<K, V>[],
+          notifier.fields,
+          skjson,
+        )
+      : (skjson.importJSON(skvalues, true) as Entry<K, V>[]);
     const isInitial = isUpdates ? false : true;
     notifier.notify({
       values,
@@ -1133,6 +1311,7 @@ export class ToBinding {
       this.binding,
       this.getConverter(),
       this.handles,
+      this.jsonPatterns,
       this.needGC.bind(this),
       this.runWithGC,
     );
@@ -53,3 +53,6 @@ export type Notifier = T<typeof notifier>;
 
 declare const request: unique symbol;
 export type Request = T<typeof request>;
+
+declare const jsonpattern: unique symbol;
+export type JsonPattern = T<typeof jsonpattern>;
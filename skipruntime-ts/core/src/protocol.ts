@@ -0,0 +1,373 @@
+/**
+ * Binary framing of the streams of updates between Skip services.
+ *
+ * A stream is a sequence of frames, each made of a one-byte frame kind, the
+ * length of the payload as a big-endian 32-bit integer, and the payload.
+ * The payload of `init` and `update` frames is the watermark of the update
+ * followed by its entries, in the same shape as a `CollectionUpdate`. An
+ * `init` frame replaces the whole state of the subscriber: it is sent first,
+ * and again whenever the subscriber must resynchronize.
+ *
+ * Values are encoded with a tag byte followed by:
+ * - nothing, for `null`, `false` and `true`;
+ * - a varint of `n` or of `-n - 1`, for non-negative or negative integers
+ *   `n` that are safe in JavaScript;
+ * - a little-endian 64-bit float, for other numbers;
+ * - a varint byte length and UTF-8 bytes, for strings;
+ * - a varint count and the elements, for arrays;
+ * - a varint count and the key/value pairs, for objects, with keys encoded
+ *   as strings without their tag.
+ *
+ * @packageDocumentation
+ */
+
+import type { Json } from "../skiplang-json/index.js";
+import type { CollectionUpdate, Entry, Watermark } from "./api.js";
+import { SkipProtocolError } from "./errors.js";
+
+/**
+ * Media type of binary streams, used to negotiate them against server-sent events.
+ */
+export const binaryStreamContentType = "application/x-skip-stream";
+
+enum Frame {
+  Init = 1,
+  Update = 2,
+}
+
+enum Tag {
+  Null = 0,
+  False = 1,
+  True = 2,
+  Int = 3,
+  Float = 4,
+  String = 5,
+  Array = 6,
+  Object = 7,
+  NegativeInt = 8,
+}
+
+const headerSize = 5;
+const encoder = new TextEncoder();
+const decoder = new TextDecoder("utf-8", { fatal: true });
+
+class Writer {
+  private bytes = new Uint8Array(256);
+  private view = new DataView(this.bytes.buffer);
+  pos = 0;
+
+  finish(): Uint8Array {
+    return this.bytes.subarray(0, this.pos);
+  }
+
+  byte(b: number): void {
+    this.reserve(1);
+    this.bytes[this.pos++] = b;
+  }
+
+  uint32At(pos: number, n: number): void {
+    this.view.setUint32(pos, n);
+  }
+
+  // Safe non-negative integers, which do not fit bitwise operators.
+  varint(n: number): void {
+    this.reserve(8);
+    while (n >= 0x80) {
+      this.bytes[this.pos++] = (n % 0x80) | 0x80;
+      n = Math.floor(n / 0x80);
+    }
+    this.bytes[this.pos++] = n;
+  }
+
+  float(x: number): void {
+    this.reserve(8);
+    this.view.setFloat64(this.pos, x, true);
+    this.pos += 8;
+  }
+
+  string(s: string): void {
+    // UTF-8 takes at most three bytes per UTF-16 code unit.
+    const max = s.length * 3;
+    this.reserve(max + 8);
+    if (max < 0x80) {
+      const { written } = encoder.encodeInto(
+        s,
+        this.bytes.subarray(this.pos + 1),
+      );
+      this.bytes[this.pos] = written;
+      this.pos += 1 + written;
+    } else {
+      const bytes = encoder.encode(s);
+      this.varint(bytes.length);
+      this.bytes.set(bytes, this.pos);
+      this.pos += bytes.length;
+    }
+  }
+
+  value(v: Json | null): void {
+    if (v === null) {
+      this.byte(Tag.Null);
+    } else if (typeof v == "boolean") {
+      this.byte(v ? Tag.True : Tag.False);
+    } else if (typeof v == "number") {
+      if (Number.isSafeInteger(v) && !Object.is(v, -0)) {
+        this.byte(v >= 0 ? Tag.Int : Tag.NegativeInt);
+        this.varint(v >= 0 ? v : -v - 1);
+      } else {
+        this.byte(Tag.Float);
+        this.float(v);
+      }
+    } else if (typeof v == "string") {
+      this.byte(Tag.String);
+      this.string(v);
+    } else if (Array.isArray(v)) {
+      this.byte(Tag.Array);
+      this.varint(v.length);
+      for (const x of v) this.value(x);
+    } else {
+      const keys = Object.keys(v);
+      this.byte(Tag.Object);
+      this.varint(keys.length);
+      for (const key of keys) {
+        this.string(key);
+        this.value(v[key] ?? null);
+      }
+    }
+  }
+
+  private reserve(n: number): void {
+    if (this.pos + n <= this.bytes.length) return;
+    let size = this.bytes.length * 2;
+    while (size < this.pos + n) size *= 2;
+    const bytes = new Uint8Array(size);
+    bytes.set(this.bytes.subarray(0, this.pos));
+    this.bytes = bytes;
+    this.view = new DataView(bytes.buffer);
+  }
+}
+
+class Reader {
+  private readonly view: DataView;
+  private pos = 0;
+
+  constructor(private readonly bytes: Uint8Array) {
+    this.view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  }
+
+  done(): boolean {
+    return this.pos == this.bytes.length;
+  }
+
+  byte(): number {
+    if (this.pos >= this.bytes.length) truncated();
+    return this.bytes[this.pos++]!;
+  }
+
+  varint(): number {
+    let n = 0;
+    let scale = 1;
+    for (;;) {
+      const b = this.byte();
+      n += (b & 0x7f) * scale;
+      if (b < 0x80) return n;
+      scale *= 0x80;
+      if (scale > 2 ** 56) {
+        throw new SkipProtocolError("Invalid varint in binary stream");
+      }
+    }
+  }
+
+  float(): number {
+    if (this.pos + 8 > this.bytes.length) truncated();
+    const x = this.view.getFloat64(this.pos, true);
+    this.pos += 8;
+    return x;
+  }
+
+  string(): string {
+    const length = this.varint();
+    if (this.pos + length > this.bytes.length) truncated();
+    const s = decoder.decode(this.bytes.subarray(this.pos, this.pos + length));
+    this.pos += length;
+    return s;
+  }
+
+  value(): Json | null {
+    const tag = this.byte();
+    switch (tag as Tag) {
+      case Tag.Null:
+        return null;
+      case Tag.False:
+        return false;
+      case Tag.True:
+        return true;
+      case Tag.Int:
+        return this.varint();
+      case Tag.NegativeInt:
+        return -this.varint() - 1;
+      case Tag.Float:
+        return this.float();
+      case Tag.String:
+        return this.string();
+      case Tag.Array: {
+        const length = this.varint();
+        const values: (Json | null)[] = [];
+        for (let i = 0; i < length; i++) values.push(this.value());
+        return values;
+      }
+      case Tag.Object: {
+        const length = this.varint();
+        const obj: { [key: string]: Json | null } = {};
+        for (let i = 0; i < length; i++) {
+          const key = this.string();
+          obj[key] = this.value();
+        }
+        return obj;
+      }
+      default:
+        throw new SkipProtocolError(
+          `Invalid value tag ${tag.toString()} in binary stream`,
+        );
+    }
+  }
+}
+
+function truncated(): never {
+  throw new SkipProtocolError("Truncated binary stream frame");
+}
+
+/**
+ * Encode an update as a binary stream frame.
+ *
+ * @param update - The update to encode.
+ * @returns The frame, ready to be written to the stream.
+ */
+export function encodeFrame(update: CollectionUpdate<Json, Json>): Uint8Array {
+  const w = new Writer();
+  w.byte(update.isInitial ? Frame.Init : Frame.Update);
+  w.pos = headerSize;
+  w.string(update.watermark);
+  w.varint(update.values.length);
+  for (const [key, values] of update.values) {
+    w.value(key);
+    w.varint(values.length);
+    for (const value of values) w.value(value);
+  }
+  w.uint32At(1, w.pos - headerSize);
+  return w.finish();
+}
+
+function decodeFrame(
+  kind: number,
+  payload: Uint8Array,
+): CollectionUpdate<Json, Json> {
+  let isInitial: boolean;
+  switch (kind as Frame) {
+    case Frame.Init:
+      isInitial = true;
+      break;
+    case Frame.Update:
+      isInitial = false;
+      break;
+    default:
+      throw new SkipProtocolError(
+        `Invalid frame kind ${kind.toString()} in binary stream`,
+      );
+  }
+  const r = new Reader(payload);
+  const watermark = r.string() as Watermark;
+  const length = r.varint();
+  const entries: Entry<Json, Json>[] = [];
+  for (let i = 0; i < length; i++) {
+    const key = r.value() as Json;
+    const count = r.varint();
+    const values: Json[] = [];
+    for (let j = 0; j < count; j++) values.push(r.value() as Json);
+    entries.push([key, values]);
+  }
+  if (!r.done()) {
+    throw new SkipProtocolError("Trailing bytes in binary stream frame");
+  }
+  return { values: entries, watermark, isInitial };
+}
+
+/**
+ * Incremental decoder of binary streams.
+ *
+ * Chunks of the stream are pushed as they are received, regardless of frame
+ * boundaries; the updates of the frames they complete are returned.
+ */
+export class FrameDecoder {
+  // Bytes received after the last complete frame, as they were pushed. They
+  // are only concatenated once they hold a whole frame, so that a frame split
+  // over many chunks is copied once rather than once per chunk.
+  private pending: Uint8Array[] = [];
+  private pendingLength = 0;
+  // Size of the frame at the start of `pending`, once its header is known.
+  private frameLength = 0;
+
+  /**
+   * Decode the frames completed by a chunk of the stream.
+   *
+   * @param chunk - Next bytes of the stream.
+   * @returns The updates of the frames completed by `chunk`, in order.
+   * @throws {SkipProtocolError} If the stream is malformed.
+   */
+  push(chunk: Uint8Array): CollectionUpdate<Json, Json>[] {
+    let bytes = chunk;
+    if (this.pendingLength > 0) {
+      this.pending.push(chunk);
+      this.pendingLength += chunk.length;
+      if (this.frameLength == 0 && this.pendingLength >= headerSize) {
+        this.frameLength = headerSize + this.pendingPayloadLength();
+      }
+      if (this.frameLength == 0 || this.pendingLength < this.frameLength) {
+        return [];
+      }
+      bytes = new Uint8Array(this.pendingLength);
+      let offset = 0;
+      for (const part of this.pending) {
+        bytes.set(part, offset);
+        offset += part.length;
+      }
+    }
+    const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+    const updates: CollectionUpdate<Json, Json>[] = [];
+    let pos = 0;
+    let end = 0;
+    while (bytes.length - pos >= headerSize) {
+      end = pos + headerSize + view.getUint32(pos + 1);
+      if (end > bytes.length) break;
+      updates.push(
+        decodeFrame(bytes[pos]!, bytes.subarray(pos + headerSize, end)),
+      );
+      pos = end;
+    }
+    const rest = bytes.subarray(pos);
+    this.pending = rest.length > 0 ? [rest] : [];
+    this.pendingLength = rest.length;
+    this.frameLength = rest.length >= headerSize ? end - pos : 0;
+    return updates;
+  }
+
+  /**
+   * Whether the stream ended on a frame boundary.
+   */
+  isComplete(): boolean {
+    return this.pendingLength == 0;
+  }
+
+  // The payload length in the header of the first pending frame, which may
+  // span several chunks.
+  private pendingPayloadLength(): number {
+    const header = new Uint8Array(headerSize);
+    let length = 0;
+    for (const part of this.pending) {
+      const n = Math.min(part.length, headerSize - length);
+      header.set(part.subarray(0, n), length);
+      length += n;
+      if (length == headerSize) break;
+    }
+    return new DataView(header.buffer).getUint32(1);
+  }
+}
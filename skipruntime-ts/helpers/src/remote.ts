@@ -2,7 +2,18 @@
 // in nodejs LTS.
 import EventSource from "eventsource";
 
-import type { Entry, ExternalService, Json } from "@skipruntime/core";
+import type {
+  CollectionUpdate,
+  Entry,
+  ExternalService,
+  Json,
+  Watermark,
+} from "@skipruntime/core";
+import { SkipFetchError } from "@skipruntime/core";
+import {
+  binaryStreamContentType,
+  FrameDecoder,
+} from "@skipruntime/core/protocol.js";
 
 import type { Entrypoint } from "./rest.js";
 
@@ -10,10 +21,79 @@ interface Closable {
   close(): void;
 }
 
+const reconnectDelayMs = 1000;
+
+// Incremental parser of a `text/event-stream` body, for the services that
+// answer a request for binary frames with server-sent events. Only the
+// `init` and `update` events of Skip streams are decoded.
+class EventDecoder {
+  private readonly text = new TextDecoder();
+  private buffer = "";
+  private event = "";
+  private id = "";
+  private data: string[] = [];
+
+  push(chunk: Uint8Array): CollectionUpdate<Json, Json>[] {
+    this.buffer += this.text.decode(chunk, { stream: true });
+    const updates: CollectionUpdate<Json, Json>[] = [];
+    let start = 0;
+    for (;;) {
+      const end = this.buffer.indexOf("\n", start);
+      if (end < 0) break;
+      let line = this.buffer.slice(start, end);
+      start = end + 1;
+      if (line.endsWith("\r")) line = line.slice(0, -1);
+      if (line == "") {
+        // A blank line dispatches the event.
+        if (this.event == "init" || this.event == "update") {
+          updates.push({
+            values: JSON.parse(this.data.join("\n")) as Entry<Json, Json>[],
+            watermark: this.id as Watermark,
+            isInitial: this.event == "init",
+          });
+        }
+        this.event = "";
+        this.data = [];
+        continue;
+      }
+      const colon = line.indexOf(":");
+      if (colon == 0) continue; // Comment.
+      const field = colon < 0 ? line : line.slice(0, colon);
+      let value = colon < 0 ? "" : line.slice(colon + 1);
+      if (value.startsWith(" ")) value = value.slice(1);
+      switch (field) {
+        case "event":
+          this.event = value;
+          break;
+        case "id":
+          this.id = value;
+          break;
+        case "data":
+          this.data.push(value);
+          break;
+      }
+    }
+    this.buffer = this.buffer.slice(start);
+    return updates;
+  }
+}
+
+type Callbacks = {
+  update: (updates: Entry<Json, Json>[], isInitial: boolean) => void;
+  // FIXME: What is `error()` used for?
+  error: (error: Json) => void;
+  // FIXME: What is `loading()` used for?
+  loading: () => void;
+};
+
 /**
  * An external Skip reactive service.
  *
  * `SkipExternalService` provides an implementation of `ExternalService` for an external Skip service.
+ *
+ * Updates are received as server-sent events, or as binary frames with the `binary` option, which saves encoding and parsing JSON text on both ends.
+ * Services that do not support binary frames answer with server-sent events instead.
+ * Either way, an interrupted stream is resumed from the last update received, so that only the changes missed in between are sent again.
  */
 export class SkipExternalService implements ExternalService {
   private readonly resources = new Map<string, Closable>();
@@ -21,40 +101,42 @@ export class SkipExternalService implements ExternalService {
   /**
    * @param url - URL to use for the service's streaming interface.
    * @param control_url - URL to use for the service's control interface.
+   * @param options - Optional parameters.
+   * @param options.binary - Receive updates as binary frames rather than server-sent events.
    */
   constructor(
     private readonly url: string,
     private readonly control_url: string,
+    private readonly options: { binary?: boolean } = {},
   ) {}
 
   /**
    * Constructor accepting an `Entrypoint`.
    *
    * @param entrypoint - The entry point for the external Skip service.
+   * @param options - Optional parameters.
+   * @param options.binary - Receive updates as binary frames rather than server-sent events.
    * @returns An `ExternalService` to interact with the service running at `entrypoint`.
    */
   // TODO: Support Skip external services going through a gateway.
-  static direct(entrypoint: Entrypoint): SkipExternalService {
+  static direct(
+    entrypoint: Entrypoint,
+    options: { binary?: boolean } = {},
+  ): SkipExternalService {
     let url = `http://${entrypoint.host}:${entrypoint.streaming_port.toString()}`;
     let control_url = `http://${entrypoint.host}:${entrypoint.control_port.toString()}`;
     if (entrypoint.secured) {
       url = `https://${entrypoint.host}:${entrypoint.streaming_port.toString()}`;
       control_url = `https://${entrypoint.host}:${entrypoint.control_port.toString()}`;
     }
-    return new SkipExternalService(url, control_url);
+    return new SkipExternalService(url, control_url, options);
   }
 
   subscribe(
     instance: string,
     resource: string,
     params: Json,
-    callbacks: {
-      update: (updates: Entry<Json, Json>[], isInitial: boolean) => void;
-      // FIXME: What is `error()` used for?
-      error: (error: Json) => void;
-      // FIXME: What is `loading()` used for?
-      loading: () => void;
-    },
+    callbacks: Callbacks,
   ): void {
     // TODO Manage Status
     fetch(`${this.control_url}/v1/streams/${resource}`, {
@@ -66,25 +148,94 @@ export class SkipExternalService implements ExternalService {
     })
       .then((resp) => resp.text())
       .then((uuid) => {
-        const evSource = new EventSource(`${this.url}/v1/streams/${uuid}`);
-        evSource.addEventListener("init", (e: MessageEvent<string>) => {
-          const updates = JSON.parse(e.data) as Entry<Json, Json>[];
-          callbacks.update(updates, true);
-        });
-        evSource.addEventListener("update", (e: MessageEvent<string>) => {
-          const updates = JSON.parse(e.data) as Entry<Json, Json>[];
-          callbacks.update(updates, false);
-        });
-        evSource.onerror = (e) => {
-          console.log(e);
-        };
-        this.resources.set(instance, evSource);
+        const url = `${this.url}/v1/streams/${uuid}`;
+        if (this.options.binary) {
+          this.streamFrames(instance, url, callbacks);
+        } else {
+          this.streamEvents(instance, url, callbacks);
+        }
       })
       .catch((e: unknown) => {
         console.log(e);
       });
   }
 
+  private streamEvents(instance: string, url: string, callbacks: Callbacks) {
+    const evSource = new EventSource(url);
+    evSource.addEventListener("init", (e: MessageEvent<string>) => {
+      const updates = JSON.parse(e.data) as Entry<Json, Json>[];
+      callbacks.update(updates, true);
+    });
+    evSource.addEventListener("update", (e: MessageEvent<string>) => {
+      const updates = JSON.parse(e.data) as Entry<Json, Json>[];
+      callbacks.update(updates, false);
+    });
+    evSource.onerror = (e) => {
+      console.log(e);
+    };
+    this.resources.set(instance, evSource);
+  }
+
+  // Like `EventSource`, reconnects when the stream ends or fails, and then
+  // resumes from the watermark of the last update received. Reads either
+  // binary frames or server-sent events, depending on what the service
+  // answers.
+  private streamFrames(
+    instance: string,
+    url: string,
+    callbacks: Callbacks,
+    watermark?: string,
+  ) {
+    const controller = new AbortController();
+    const stream = {
+      close: () => {
+        controller.abort();
+      },
+    };
+    this.resources.set(instance, stream);
+    const headers: { [header: string]: string } = {
+      Accept: `${binaryStreamContentType}, text/event-stream;q=0.5`,
+    };
+    if (watermark !== undefined) headers["Last-Event-ID"] = watermark;
+    let retry = true;
+    fetch(url, { headers, signal: controller.signal })
+      .then(async (resp) => {
+        if (!resp.ok || !resp.body) {
+          retry = resp.status >= 500;
+          throw new SkipFetchError(
+            `${resp.status.toString()}: ${resp.statusText}`,
+          );
+        }
+        // A service that only streams server-sent events answers with them.
+        // They are read from this response: subscribing again on the same
+        // stream would race with the server closing this one.
+        const contentType = resp.headers.get("Content-Type") ?? "";
+        const decoder = contentType.startsWith(binaryStreamContentType)
+          ? new FrameDecoder()
+          : new EventDecoder();
+        const reader = resp.body.getReader();
+        for (;;) {
+          const { done, value } = await reader.read();
+          if (done) break;
+          for (const update of decoder.push(value)) {
+            watermark = update.watermark;
+            callbacks.update(update.values, update.isInitial ?? false);
+          }
+        }
+      })
+      .catch((e: unknown) => {
+        if (!controller.signal.aborted) console.log(e);
+      })
+      .finally(() => {
+        if (!retry || this.resources.get(instance) !== stream) return;
+        setTimeout(() => {
+          if (this.resources.get(instance) === stream) {
+            this.streamFrames(instance, url, callbacks, watermark);
+          }
+        }, reconnectDelayMs);
+      });
+  }
+
   unsubscribe(instance: string) {
     const closable = this.resources.get(instance);
     if (closable) {
@@ -151,6 +151,29 @@ export class SkipServiceBroker {
     return data ?? [];
   }
 
+  /**
+   * Read the values a resource associates with each of several keys, in a single request.
+   *
+   * @typeParam K - Type of keys.
+   * @typeParam V - Type of values.
+   * @param resource - Name of resource, must be a key of the `resources` field of the `SkipService` running at `entrypoint`.
+   * @param params - Resource instance parameters.
+   * @param keys - Keys to read.
+   * @returns The values associated to each key, in the order of `keys`.
+   */
+  async getArrays<K extends Json, V extends Json>(
+    resource: string,
+    params: Json,
+    keys: K[],
+  ): Promise<V[][]> {
+    const [data, _headers] = await fetchJSON<V[][]>(
+      `${this.entrypoint}/v1/snapshot/${resource}/lookups`,
+      "POST",
+      { body: { keys, params }, timeout: this.timeout },
+    );
+    return data ?? [];
+  }
+
   /**
    * Read the single value a resource associates with a key.
    *
@@ -1,84 +1,93 @@
 import express from "express";
+import type { Request, Response, NextFunction } from "express";
 import {
-  ServiceInstance,
   SkipUnknownCollectionError,
   SkipResourceInstanceInUseError,
   SkipRESTError,
 } from "@skipruntime/core";
-import type { CollectionUpdate, Entry, Json } from "@skipruntime/core";
+import type { Entry, Json, SubscriptionFilter } from "@skipruntime/core";
+import {
+  binaryStreamContentType,
+  encodeFrame,
+} from "@skipruntime/core/protocol.js";
+import type { Service } from "./service.js";
+import { UpdateStream } from "./sse.js";
 
-export function controlService(service: ServiceInstance): express.Express {
+export function controlService(service: Service): express.Express {
   const app = express();
   app.use(express.json({ strict: false }));
 
+  const fail = (res: Response) => (e: unknown) => {
+    console.log(e);
+    res.status(500).json(e instanceof Error ? e.message : e);
+  };
+
   // Streaming control API.
   app.post("/v1/streams/:resource", (req, res) => {
-    try {
-      const uuid = crypto.randomUUID();
-      service.instantiateResource(uuid, req.params.resource, req.body as Json);
-      res.status(201).send(uuid);
-    } catch (e: unknown) {
-      console.log(e);
-      res.status(500).json(e instanceof Error ? e.message : e);
-    }
+    const uuid = crypto.randomUUID();
+    service
+      .instantiateResource(uuid, req.params.resource, req.body as Json)
+      .then(() => {
+        res.status(201).send(uuid);
+      }, fail(res));
   });
 
   app.delete("/v1/streams/:uuid", (req, res) => {
-    try {
-      service.closeResourceInstance(req.params.uuid);
+    service.closeResourceInstance(req.params.uuid).then(() => {
       res.sendStatus(200);
-    } catch (e: unknown) {
-      console.log(e);
-      res.status(500).json(e instanceof Error ? e.message : e);
-    }
+    }, fail(res));
   });
 
   // READS
   app.post("/v1/snapshot/:resource", (req, res) => {
-    try {
-      const callbacks = {
-        resolve: (data: Json[]) => {
-          res.status(200).json(data);
-        },
-        reject: (err: unknown) => {
-          res.status(500).json(err instanceof Error ? err.message : err);
-        },
-      };
-      service.getAll(req.params.resource, req.body as Json, callbacks);
-    } catch (e: unknown) {
-      console.log(e);
-      res.status(500).json(e instanceof Error ? e.message : e);
-    }
+    service.getAll(req.params.resource, req.body as Json).then((data) => {
+      res.status(200).json(data);
+    }, fail(res));
   });
 
   app.post("/v1/snapshot/:resource/lookup", (req, res) => {
-    try {
-      const callbacks = {
-        resolve: (data: Json[]) => {
-          res.status(200).json(data);
-        },
-        reject: (err: unknown) => {
-          res.status(500).json(err instanceof Error ? err.message : err);
-        },
-      };
-      if (
-        typeof req.body != "object" ||
-        !("key" in req.body) ||
-        !("params" in req.body)
-      )
-        throw new SkipRESTError(
+    if (
+      typeof req.body != "object" ||
+      !("key" in req.body) ||
+      !("params" in req.body)
+    ) {
+      fail(res)(
+        new SkipRESTError(
           `Invalid request body for synchronous lookup: ${JSON.stringify(req.body)}`,
-        );
-      service.getArray(
-        req.params.resource,
-        req.body.key,
-        req.body.params as Json,
-        callbacks,
+        ),
+      );
+      return;
+    }
+    service
+      .getArray(req.params.resource, req.body.key, req.body.params as Json)
+      .then((data) => {
+        res.status(200).json(data);
+      }, fail(res));
+  });
+
+  app.post("/v1/snapshot/:resource/lookups", (req, res) => {
+    if (
+      typeof req.body != "object" ||
+      !("keys" in req.body) ||
+      !Array.isArray(req.body.keys) ||
+      !("params" in req.body)
+    ) {
+      fail(res)(
+        new SkipRESTError(
+          `Invalid request body for synchronous lookups: ${JSON.stringify(req.body)}`,
+        ),
       );
-    } catch (e: unknown) {
-      console.log(e);
-      res.status(500).json(e instanceof Error ? e.message : e);
+      return;
     }
+    service
+      .getArrays(
+        req.params.resource,
+        req.body.keys as Json[],
+        req.body.params as Json,
+      )
+      .then((data) => {
+        res.status(200).json(data);
+      }, fail(res));
   });
 
   // WRITES
@@ -87,17 +96,20 @@ export function controlService(service: ServiceInstance): express.Express {
       res.status(400).json(`Bad request body ${JSON.stringify(req.body)}`);
       return;
     }
-    try {
-      service.update(req.params.collection, req.body as Entry<Json, Json>[]);
-      res.sendStatus(200);
-    } catch (e: unknown) {
-      if (e instanceof SkipUnknownCollectionError) {
-        res.sendStatus(404);
-      } else {
-        console.log(e);
-        res.status(500).json(e instanceof Error ? e.message : e);
-      }
-    }
+    service
+      .update(req.params.collection, req.body as Entry<Json, Json>[])
+      .then(
+        () => {
+          res.sendStatus(200);
+        },
+        (e: unknown) => {
+          if (e instanceof SkipUnknownCollectionError) {
+            res.sendStatus(404);
+          } else {
+            fail(res)(e);
+          }
+        },
+      );
   });
 
   app.get("/v1/healthcheck", (_, res) => {
@@ -107,51 +119,129 @@ export function controlService(service: ServiceInstance): express.Express {
   return app;
 }
 
-export function streamingService(service: ServiceInstance): express.Express {
+// The `keys`, `start`/`end` and `fields` query parameters of a stream request,
+// or null if malformed.
+function parseFilter(
+  query: Request["query"],
+): SubscriptionFilter | undefined | null {
+  const param = (name: string) => {
+    const value = query[name];
+    return typeof value == "string" ? value : undefined;
+  };
+  const keys = param("keys");
+  const start = param("start");
+  const end = param("end");
+  const fields = param("fields");
+  if ((start === undefined) != (end === undefined)) return null;
+  if (!keys && start === undefined && !fields) return undefined;
+  try {
+    const filter: SubscriptionFilter = {};
+    if (keys) {
+      const parsed = JSON.parse(keys) as Json;
+      if (!Array.isArray(parsed) || parsed.includes(null)) return null;
+      filter.keys = parsed as Json[];
+    }
+    if (start !== undefined && end !== undefined) {
+      const range = [JSON.parse(start), JSON.parse(end)] as (Json | null)[];
+      if (range.includes(null)) return null;
+      filter.range = { start: range[0]!, end: range[1]! };
+    }
+    if (fields) filter.fields = fields.split(",");
+    return filter;
+  } catch {
+    return null;
+  }
+}
+
+export function streamingService(
+  service: Service,
+  coalesceMs: number = 0,
+): express.Express {
   const app = express();
 
   app.get("/v1/streams/:uuid", (req, res) => {
-    if (!req.accepts("text/event-stream")) {
+    // Other Skip services may ask for binary frames, see protocol.ts in core.
+    const contentType = req.accepts([
+      "text/event-stream",
+      binaryStreamContentType,
+    ]);
+    if (!contentType) {
       res.sendStatus(406);
       return;
     }
-    try {
-      const uuid = req.params.uuid;
-      const subscriptionID = service.subscribe(uuid, {
-        subscribed: () => {
-          res.set("Content-Type", "text/event-stream");
-          res.set("Connection", "keep-alive");
-          res.set("Cache-Control", "no-cache");
-          res.status(200);
-          res.flushHeaders();
+    const filter = parseFilter(req.query);
+    if (filter === null) {
+      res.sendStatus(400);
+      return;
+    }
+    const stream =
+      contentType == binaryStreamContentType
+        ? new UpdateStream(res, coalesceMs, encodeFrame)
+        : new UpdateStream(res, coalesceMs);
+    let closed = false;
+    req.on("close", () => {
+      closed = true;
+      stream.dispose();
+    });
+    service
+      .subscribe(
+        req.params.uuid,
+        {
+          subscribed: () => {
+            res.set("Content-Type", contentType);
+            res.set("Connection", "keep-alive");
+            res.set("Cache-Control", "no-cache");
+            res.status(200);
+            res.flushHeaders();
+          },
+          notify: (update) => {
+            stream.notify(update);
+          },
+          close: () => {
+            stream.close();
+          },
         },
-        notify: (update: CollectionUpdate<string, Json>) => {
-          if (update.isInitial) {
-            res.write(`event: init\n`);
+        // A reconnecting client sends the watermark of the last update it
+        // received, and is then only sent the changes since.
+        req.get("Last-Event-ID"),
+        filter,
+      )
+      .then(
+        (subscriptionID) => {
+          // The subscription is only known once established.
+          if (closed) {
+            service.unsubscribe(subscriptionID);
           } else {
-            res.write(`event: update\n`);
+            req.on("close", () => {
+              service.unsubscribe(subscriptionID);
+            });
           }
-          res.write(`id: ${update.watermark}\n`);
-          res.write(`data: ${JSON.stringify(update.values)}\n\n`);
         },
-        close: () => {
-          res.end();
+        (e: unknown) => {
+          console.log(e);
+          if (e instanceof SkipUnknownCollectionError) {
+            res.sendStatus(404);
+          } else if (e instanceof SkipResourceInstanceInUseError) {
+            res.sendStatus(409);
+          } else {
+            res.sendStatus(500);
+          }
         },
-      });
-      req.on("close", () => {
-        service.unsubscribe(subscriptionID);
-      });
-    } catch (e: unknown) {
-      console.log(e);
-      if (e instanceof SkipUnknownCollectionError) {
-        res.sendStatus(404);
-      } else if (e instanceof SkipResourceInstanceInUseError) {
-        res.sendStatus(409);
-      } else {
-        res.sendStatus(500);
-      }
-    }
+      );
   });
 
   return app;
 }
+
+export function no_cors(req: Request, res: Response, next: NextFunction) {
+  res.header("Access-Control-Allow-Credentials", "true");
+  res.header("Access-Control-Allow-Methods", "GET,OPTIONS");
+  res.header("Access-Control-Allow-Origin", "*");
+  if (req.method.toUpperCase() == "OPTIONS") {
+    res.statusCode = 204;
+    res.setHeader("Content-Length", "0");
+    res.end();
+  } else {
+    next();
+  }
+}
@@ -5,8 +5,10 @@
  */
 
 import { type SkipService } from "@skipruntime/core";
-import { controlService, streamingService } from "./rest.js";
-import type { Express, Request, Response, NextFunction } from "express";
+import { controlService, no_cors, streamingService } from "./rest.js";
+import { localService } from "./service.js";
+import { startWorkers, stopWorkers } from "./workers.js";
+import type { Express } from "express";
 import express from "express";
 
 /**
@@ -46,6 +48,15 @@ export type SkipServer = {
  *  Responds with the values associated to `key` in the named `resource` with the given parameters, instantiating the resource if needed.
  *  Data is returned as a JSON-encoded array of values.
  *
+ * - `POST /v1/snapshot/:resource/lookups`:
+ *   Synchronous read of several keys in a resource.
+ *
+ *  The body of the request must be a JSON-encoded object with a `keys` array and a `params` field.
+ *  Responds with the values associated to each of the `keys` in the named `resource` with the given parameters, looked up together with a single resource instance.
+ *  Data is returned as a JSON-encoded array with, for each key in order, the array of its values.
+ *
+ *  If `options.snapshot_cache_ms` is set, the snapshot reads above keep a resource instance for that many milliseconds (up to 10 seconds), through which the identical reads that follow are served.
+ *
  * - `PATCH /v1/inputs/:collection`:
  *   Partial write (update only the specified keys) of an input collection.
  *
@@ -84,6 +95,22 @@ export type SkipServer = {
  *     id: <watermark>\n
  *     data: <values>\n\n
  * ```
+ *   If `options.coalesce_ms` is set, updates made within that many milliseconds are merged into a single `update` event holding the latest values of each key.
+ *   Updates are merged in the same way while a client is not reading its stream fast enough, so that it receives the latest state rather than a backlog.
+ *
+ *   A client reconnecting with a `Last-Event-ID` header, as `EventSource` does, resumes its subscription from that watermark: it receives an `update` event with the changes it missed if they are still retained, and an `init` event otherwise.
+ *
+ *   The following query parameters restrict the subscription, which is then only sent what it asks for:
+ *   - `keys`: a JSON array of the keys to be sent, e.g. `?keys=["a","b"]`;
+ *   - `start` and `end`: JSON keys bounding an inclusive range of keys to be sent, in addition to `keys`;
+ *   - `fields`: a comma-separated list of the fields to be sent of object values, e.g. `?fields=name,price`.
+ *   Malformed parameters are rejected with HTTP 400.
+ *
+ *   Requests accepting `application/x-skip-stream` instead, as sent by `SkipExternalService` with its `binary` option, receive the same updates as length-prefixed binary frames (see `protocol.ts` in `@skipruntime/core`).
+ *   This saves encoding and parsing JSON text between Skip services.
+ *
+ * If `options.workers` is set, both APIs are served by that many worker threads sharing the ports, which parse and serialize HTTP traffic while the reactive service keeps running on the calling thread.
+ * This requires Node 22.12 or later on Linux, to share ports between threads.
  *
  * @typeParam Inputs - Named collections from which the service computes.
  * @typeParam ResourceInputs - Named collections provided to resource computations.
@@ -93,6 +120,9 @@ export type SkipServer = {
  * @param options.streaming_port - Port on which streaming service will listen.
  * @param options.platform - Skip runtime platform to be used to run the service: either `wasm` (the default) or `native`.
  * @param options.no_cors - Disable CORS for the streaming endpoint.
+ * @param options.snapshot_cache_ms - Duration for which snapshot reads keep the resource instance they used, to serve identical reads; defaults to 0, creating an instance per read.
+ * @param options.coalesce_ms - Delay during which updates to a stream are merged into a single event; defaults to 0, sending each update as soon as possible.
+ * @param options.workers - Number of worker threads serving HTTP requests; defaults to 0, serving them on the calling thread.
  * @returns Object to manage the running server.
  */
 export async function runService(
@@ -102,6 +132,9 @@ export async function runService(
     control_port: number;
     platform?: "wasm" | "native";
     no_cors?: boolean;
+    coalesce_ms?: number;
+    snapshot_cache_ms?: number;
+    workers?: number;
   } = {
     streaming_port: 8080,
     control_port: 8081,
@@ -130,7 +163,28 @@ export async function runService(
     }
   }
   const instance = await runtime.initService(service);
-  const controlHttpServer = controlService(instance).listen(
+  const skipService = localService(instance, options.snapshot_cache_ms);
+  if (options.workers && options.workers > 0) {
+    const workers = await startWorkers(skipService, options.workers, {
+      control_port: options.control_port,
+      streaming_port: options.streaming_port,
+      no_cors: options.no_cors,
+      coalesce_ms: options.coalesce_ms,
+    });
+    console.log(
+      `Skip control service listening on port ${options.control_port.toString()}`,
+    );
+    console.log(
+      `Skip streaming service listening on port ${options.streaming_port.toString()}`,
+    );
+    return {
+      close: async () => {
+        await stopWorkers(workers);
+        await instance.close();
+      },
+    };
+  }
+  const controlHttpServer = controlService(skipService).listen(
     options.control_port,
     () => {
       console.log(
@@ -144,14 +198,13 @@ export async function runService(
     }
     return app;
   };
-  const streamingHttpServer = wrapMiddleware(streamingService(instance)).listen(
-    options.streaming_port,
-    () => {
-      console.log(
-        `Skip streaming service listening on port ${options.streaming_port.toString()}`,
-      );
-    },
-  );
+  const streamingHttpServer = wrapMiddleware(
+    streamingService(skipService, options.coalesce_ms),
+  ).listen(options.streaming_port, () => {
+    console.log(
+      `Skip streaming service listening on port ${options.streaming_port.toString()}`,
+    );
+  });
 
   return {
     close: async () => {
@@ -161,16 +214,3 @@ export async function runService(
     },
   };
 }
-
-function no_cors(req: Request, res: Response, next: NextFunction) {
-  res.header("Access-Control-Allow-Credentials", "true");
-  res.header("Access-Control-Allow-Methods", "GET,OPTIONS");
-  res.header("Access-Control-Allow-Origin", "*");
-  if (req.method.toUpperCase() == "OPTIONS") {
-    res.statusCode = 204;
-    res.setHeader("Content-Length", "0");
-    res.end();
-  } else {
-    next();
-  }
-}
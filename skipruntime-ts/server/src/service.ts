@@ -0,0 +1,97 @@
+import type {
+  CollectionUpdate,
+  Entry,
+  Json,
+  ServiceInstance,
+  SubscriptionFilter,
+  SubscriptionID,
+} from "@skipruntime/core";
+import { SnapshotCache } from "./snapshots.js";
+
+/**
+ * Callbacks of a subscription to a resource instance.
+ */
+export type Notifier = {
+  subscribed: () => void;
+  notify: (update: CollectionUpdate<Json, Json>) => void;
+  close: () => void;
+};
+
+/**
+ * The operations of a running service used by its HTTP APIs.
+ *
+ * The service may run on the same thread as the HTTP servers, or on another
+ * thread they send their requests to (see `workers.ts`), hence asynchronous.
+ */
+export interface Service {
+  instantiateResource(
+    identifier: string,
+    resource: string,
+    params: Json,
+  ): Promise<void>;
+  closeResourceInstance(identifier: string): Promise<void>;
+  getAll(resource: string, params: Json): Promise<Entry<Json, Json>[]>;
+  getArray(resource: string, key: Json, params: Json): Promise<Json[]>;
+  getArrays(resource: string, keys: Json[], params: Json): Promise<Json[][]>;
+  update(collection: string, entries: Entry<Json, Json>[]): Promise<void>;
+  subscribe(
+    identifier: string,
+    notifier: Notifier,
+    watermark?: string,
+    filter?: SubscriptionFilter,
+  ): Promise<SubscriptionID>;
+  unsubscribe(id: SubscriptionID): void;
+}
+
+/**
+ * The `Service` of a `ServiceInstance` running on the current thread.
+ *
+ * @param instance - The running service.
+ * @param snapshotCacheMs - Duration for which snapshot reads keep their resource instance, see `SnapshotCache`.
+ * @returns The operations of `instance`.
+ */
+export function localService(
+  instance: ServiceInstance,
+  snapshotCacheMs: number = 0,
+): Service {
+  const snapshots = new SnapshotCache(instance, snapshotCacheMs);
+  return {
+    instantiateResource: (identifier, resource, params) =>
+      call(() => {
+        instance.instantiateResource(identifier, resource, params);
+      }),
+    closeResourceInstance: (identifier) =>
+      call(() => {
+        instance.closeResourceInstance(identifier);
+      }),
+    getAll: (resource, params) =>
+      snapshots.read(resource, params, (request) =>
+        instance.getAll<Json, Json>(resource, params, request),
+      ),
+    getArray: (resource, key, params) =>
+      snapshots.read(resource, params, (request) =>
+        instance.getArray<Json, Json>(resource, key, params, request),
+      ),
+    getArrays: (resource, keys, params) =>
+      snapshots.read(resource, params, (request) =>
+        instance.getArrays<Json, Json>(resource, keys, params, request),
+      ),
+    update: (collection, entries) =>
+      call(() => {
+        instance.update(collection, entries);
+      }),
+    subscribe: (identifier, notifier, watermark, filter) =>
+      call(() => instance.subscribe(identifier, notifier, watermark, filter)),
+    unsubscribe: (id) => {
+      instance.unsubscribe(id);
+    },
+  };
+}
+
+function call<T>(f: () => T): Promise<T> {
+  try {
+    return Promise.resolve(f());
+  } catch (e: unknown) {
+    return Promise.reject(e as Error);
+  }
+}
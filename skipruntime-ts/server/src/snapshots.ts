@@ -0,0 +1,114 @@
+import type {
+  Executor,
+  GetResult,
+  Json,
+  ServiceInstance,
+} from "@skipruntime/core";
+
+// Reading a resource instance by identifier marks it for collection, which
+// the runtime does 30 seconds later at the earliest.
+const maxCacheMs = 10000;
+
+/**
+ * Resource instances kept for a short time to serve repeated snapshot reads.
+ *
+ * Each snapshot read without a cache creates a resource instance and tears
+ * it down. Instead, once a read of some resource and parameters completed,
+ * an instance is created for them and the identical reads of the next
+ * `cacheMs` milliseconds go through it. Values are still read from the
+ * runtime, so they are as up to date as without the cache.
+ */
+export class SnapshotCache {
+  private readonly instances = new Map<string, string>();
+  private readonly cacheMs: number;
+
+  constructor(
+    private readonly service: ServiceInstance,
+    cacheMs: number,
+  ) {
+    this.cacheMs = Math.min(cacheMs, maxCacheMs);
+  }
+
+  /**
+   * Read from `resource` with `params`, through its cached instance if any.
+   *
+   * @param resource - Name of the resource.
+   * @param params - Parameters of the resource.
+   * @param read - Function reading from a resource instance: the cached one given its identifier, or a new one given an executor.
+   * @returns The values read.
+   */
+  read<T>(
+    resource: string,
+    params: Json,
+    read: (request: string | Executor<T>) => GetResult<T>,
+  ): Promise<T> {
+    const cached = this.readCached(resource, params, read);
+    if (cached !== undefined) return Promise.resolve(cached);
+    return new Promise((resolve, reject) => {
+      try {
+        read({
+          resolve: (value: T) => {
+            this.add(resource, params);
+            resolve(value);
+          },
+          reject,
+        });
+      } catch (e: unknown) {
+        reject(e as Error);
+      }
+    });
+  }
+
+  private readCached<T>(
+    resource: string,
+    params: Json,
+    read: (identifier: string) => GetResult<T>,
+  ): T | undefined {
+    if (this.cacheMs <= 0) return undefined;
+    const key = cacheKey(resource, params);
+    const identifier = this.instances.get(key);
+    if (identifier === undefined) return undefined;
+    try {
+      const result = read(identifier);
+      if (result.errors.length == 0 && result.request === undefined) {
+        return result.payload;
+      }
+    } catch {
+      // The instance is gone; reads fall back to a new instance.
+    }
+    this.evict(key, identifier);
+    return undefined;
+  }
+
+  // Caches an instance of `resource` with `params`, after a read completed.
+  private add(resource: string, params: Json): void {
+    if (this.cacheMs <= 0) return;
+    const key = cacheKey(resource, params);
+    if (this.instances.has(key)) return;
+    const identifier = crypto.randomUUID();
+    try {
+      this.service.instantiateResource(identifier, resource, params);
+    } catch (e: unknown) {
+      console.log(e);
+      return;
+    }
+    this.instances.set(key, identifier);
+    setTimeout(() => {
+      this.evict(key, identifier);
+    }, this.cacheMs).unref();
+  }
+
+  private evict(key: string, identifier: string): void {
+    if (this.instances.get(key) !== identifier) return;
+    this.instances.delete(key);
+    try {
+      this.service.closeResourceInstance(identifier);
+    } catch {
+      // Already collected, or the service is closed.
+    }
+  }
+}
+
+function cacheKey(resource: string, params: Json): string {
+  return `${resource}\n${JSON.stringify(params)}`;
+}
@@ -0,0 +1,161 @@
+import type {
+  CollectionUpdate,
+  Entry,
+  Json,
+  Watermark,
+} from "@skipruntime/core";
+
+/**
+ * The part of an HTTP response used to stream updates.
+ */
+export interface EventSink {
+  write(chunk: string | Uint8Array): boolean;
+  once(event: "drain", listener: () => void): unknown;
+  end(): unknown;
+}
+
+/**
+ * Serialize an update as a server-sent event.
+ *
+ * @param update - The update to serialize.
+ * @returns The event, of the form `event: (init|update)\nid: <watermark>\ndata: <values>\n\n`.
+ */
+export function encodeEvent(update: CollectionUpdate<Json, Json>): string {
+  const event = update.isInitial ? "init" : "update";
+  return `event: ${event}\nid: ${update.watermark}\ndata: ${JSON.stringify(update.values)}\n\n`;
+}
+
+/**
+ * Stream of the updates of a resource instance.
+ *
+ * Updates are serialized by `encode`, as server-sent events by default.
+ * Each event is serialized once and written with a single `write`. Updates
+ * that arrive within `coalesceMs` of the first pending one are merged into
+ * a single event, keeping the latest values of each key. When the client
+ * falls behind, i.e. the socket buffer is full, updates keep being merged
+ * until it drains: a slow client receives one diff instead of a backlog.
+ */
+export class UpdateStream {
+  // Entries of the next event. `keys` indexes them by serialized key, and
+  // is only built once a second update has to be merged.
+  private entries: Entry<Json, Json>[] | null = null;
+  private keys: Map<string, number> | null = null;
+  private isInitial = false;
+  private watermark = "" as Watermark;
+  private timer: ReturnType<typeof setTimeout> | null = null;
+  private blocked = false;
+  private closed = false;
+
+  constructor(
+    private readonly sink: EventSink,
+    private readonly coalesceMs: number = 0,
+    private readonly encode: (
+      update: CollectionUpdate<Json, Json>,
+    ) => string | Uint8Array = encodeEvent,
+  ) {}
+
+  notify(update: CollectionUpdate<Json, Json>): void {
+    if (this.closed) return;
+    if (update.isInitial || this.entries === null) {
+      this.entries = update.values;
+      this.keys = null;
+      this.isInitial = update.isInitial ?? false;
+    } else {
+      this.merge(update.values);
+    }
+    this.watermark = update.watermark;
+    this.schedule();
+  }
+
+  /**
+   * Writes the pending event, if any, and ends the stream.
+   *
+   * The event is written even if the client is behind: the sink only ends
+   * once its buffered data has been sent.
+   */
+  close(): void {
+    if (this.closed) return;
+    this.cancelTimer();
+    this.flush();
+    this.closed = true;
+    this.sink.end();
+  }
+
+  /**
+   * Drops the pending event, for when the client went away.
+   */
+  dispose(): void {
+    this.cancelTimer();
+    this.closed = true;
+    this.entries = null;
+    this.keys = null;
+  }
+
+  private merge(values: Entry<Json, Json>[]): void {
+    let entries = this.entries!;
+    let keys = this.keys;
+    if (keys === null) {
+      // First merge: `entries` is still the array of the first update, which
+      // belongs to the caller. Later merges update this copy in place.
+      entries = [...entries];
+      keys = new Map();
+      for (let i = 0; i < entries.length; i++) {
+        keys.set(JSON.stringify(entries[i]![0]), i);
+      }
+    }
+    for (const entry of values) {
+      const key = JSON.stringify(entry[0]);
+      const index = keys.get(key);
+      if (index !== undefined) {
+        entries[index] = entry;
+      } else {
+        keys.set(key, entries.length);
+        entries.push(entry);
+      }
+    }
+    this.entries = entries;
+    this.keys = keys;
+  }
+
+  private schedule(): void {
+    if (this.blocked || this.timer !== null) return;
+    if (this.coalesceMs <= 0) {
+      this.flush();
+    } else {
+      this.timer = setTimeout(() => {
+        this.timer = null;
+        this.flush();
+      }, this.coalesceMs);
+    }
+  }
+
+  private cancelTimer(): void {
+    if (this.timer !== null) {
+      clearTimeout(this.timer);
+      this.timer = null;
+    }
+  }
+
+  private flush(): void {
+    if (this.closed || this.entries === null) return;
+    let entries = this.entries;
+    // An initial snapshot only lists the keys that have values.
+    if (this.isInitial && this.keys !== null) {
+      entries = entries.filter((entry) => entry[1].length > 0);
+    }
+    const payload = this.encode({
+      values: entries,
+      watermark: this.watermark,
+      isInitial: this.isInitial,
+    });
+    this.entries = null;
+    this.keys = null;
+    if (!this.sink.write(payload) && !this.blocked) {
+      this.blocked = true;
+      this.sink.once("drain", () => {
+        this.blocked = false;
+        this.flush();
+      });
+    }
+  }
+}
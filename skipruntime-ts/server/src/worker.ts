@@ -0,0 +1,220 @@
+/**
+ * Entry point of the worker threads started by `startWorkers`, see
+ * `workers.ts`.
+ */
+
+import { createServer } from "node:http";
+import type { ListenOptions, Server } from "node:net";
+import { parentPort, workerData } from "node:worker_threads";
+import type { MessagePort } from "node:worker_threads";
+import express from "express";
+import {
+  SkipError,
+  SkipRESTError,
+  SkipResourceInstanceInUseError,
+  SkipUnknownCollectionError,
+  SkipUnknownResourceError,
+} from "@skipruntime/core";
+import type {
+  Entry,
+  Json,
+  SubscriptionFilter,
+  SubscriptionID,
+} from "@skipruntime/core";
+import { FrameDecoder } from "@skipruntime/core/protocol.js";
+import { controlService, no_cors, streamingService } from "./rest.js";
+import type { Notifier, Service } from "./service.js";
+import {
+  decodeEntries,
+  encodeEntries,
+  type Call,
+  type ServiceMessage,
+  type WorkerMessage,
+  type WorkerOptions,
+} from "./workers.js";
+
+// The errors the HTTP APIs tell apart, by name.
+const errors: Record<string, new (message: string) => Error> = {
+  SkipError,
+  SkipRESTError,
+  SkipResourceInstanceInUseError,
+  SkipUnknownCollectionError,
+  SkipUnknownResourceError,
+};
+
+/**
+ * The `Service` running on the main thread, seen from a worker.
+ */
+class RemoteService implements Service {
+  private nextId = 0;
+  private readonly pending = new Map<
+    number,
+    { resolve: (value: unknown) => void; reject: (e: Error) => void }
+  >();
+  private readonly notifiers = new Map<number, Notifier>();
+  private readonly subscriptions = new Map<SubscriptionID, number>();
+
+  constructor(private readonly port: MessagePort) {
+    port.on("message", (msg: ServiceMessage) => {
+      this.receive(msg);
+    });
+  }
+
+  instantiateResource(
+    identifier: string,
+    resource: string,
+    params: Json,
+  ): Promise<void> {
+    return this.call({
+      method: "instantiateResource",
+      identifier,
+      resource,
+      params,
+    });
+  }
+
+  closeResourceInstance(identifier: string): Promise<void> {
+    return this.call({ method: "closeResourceInstance", identifier });
+  }
+
+  async getAll(resource: string, params: Json): Promise<Entry<Json, Json>[]> {
+    return decodeEntries(
+      await this.call<Uint8Array>({ method: "getAll", resource, params }),
+    );
+  }
+
+  getArray(resource: string, key: Json, params: Json): Promise<Json[]> {
+    return this.call({ method: "getArray", resource, key, params });
+  }
+
+  getArrays(resource: string, keys: Json[], params: Json): Promise<Json[][]> {
+    return this.call({ method: "getArrays", resource, keys, params });
+  }
+
+  update(collection: string, entries: Entry<Json, Json>[]): Promise<void> {
+    const frame = encodeEntries(entries);
+    return this.call({ method: "update", collection, frame }, frame);
+  }
+
+  async subscribe(
+    identifier: string,
+    notifier: Notifier,
+    watermark?: string,
+    filter?: SubscriptionFilter,
+  ): Promise<SubscriptionID> {
+    // Notifications refer to the id of the call, and may arrive before its
+    // result.
+    const id = this.post({
+      method: "subscribe",
+      identifier,
+      watermark,
+      filter,
+    });
+    this.notifiers.set(id, notifier);
+    try {
+      const subscription = await this.result<SubscriptionID>(id);
+      this.subscriptions.set(subscription, id);
+      return subscription;
+    } catch (e: unknown) {
+      this.notifiers.delete(id);
+      throw e;
+    }
+  }
+
+  unsubscribe(subscription: SubscriptionID): void {
+    const id = this.subscriptions.get(subscription);
+    if (id === undefined) return;
+    this.subscriptions.delete(subscription);
+    this.notifiers.delete(id);
+    this.post({ method: "unsubscribe", subscription });
+  }
+
+  private call<T>(call: Call, frame?: Uint8Array): Promise<T> {
+    return this.result(this.post(call, frame));
+  }
+
+  private result<T>(id: number): Promise<T> {
+    return new Promise((resolve, reject) => {
+      this.pending.set(id, {
+        resolve: resolve as (value: unknown) => void,
+        reject,
+      });
+    });
+  }
+
+  private post(call: Call, frame?: Uint8Array): number {
+    const id = this.nextId++;
+    this.port.postMessage(
+      { kind: "call", id, call } satisfies WorkerMessage,
+      frame ? [frame.buffer as ArrayBuffer] : [],
+    );
+    return id;
+  }
+
+  private receive(msg: ServiceMessage): void {
+    switch (msg.kind) {
+      case "result":
+        this.pending.get(msg.id)?.resolve(msg.value);
+        this.pending.delete(msg.id);
+        break;
+      case "error": {
+        const error = errors[msg.name] ?? Error;
+        this.pending.get(msg.id)?.reject(new error(msg.message));
+        this.pending.delete(msg.id);
+        break;
+      }
+      case "subscribed":
+        this.notifiers.get(msg.id)?.subscribed();
+        break;
+      case "notify":
+        for (const update of new FrameDecoder().push(msg.frame)) {
+          this.notifiers.get(msg.id)?.notify(update);
+        }
+        break;
+      case "close":
+        this.notifiers.get(msg.id)?.close();
+        this.notifiers.delete(msg.id);
+        break;
+      case "shutdown":
+        shutdown();
+        break;
+    }
+  }
+}
+
+function listen(app: express.Express, port: number): Promise<Server> {
+  return new Promise((resolve, reject) => {
+    const server = createServer(app);
+    server.once("error", reject);
+    // Workers share each port, and the kernel spreads connections over them.
+    // Requires Node 22.12 or later on Linux.
+    server.listen({ port, reusePort: true } as ListenOptions, () => {
+      resolve(server);
+    });
+  });
+}
+
+const port = parentPort!;
+const options = workerData as WorkerOptions;
+const service = new RemoteService(port);
+
+let streaming = streamingService(service, options.coalesce_ms);
+if (options.no_cors) {
+  streaming = express().use(no_cors).use(streaming);
+}
+const servers = await Promise.all([
+  listen(controlService(service), options.control_port),
+  listen(streaming, options.streaming_port),
+]);
+port.postMessage({ kind: "ready" } satisfies WorkerMessage);
+
+function shutdown() {
+  let open = servers.length;
+  for (const server of servers) {
+    server.close(() => {
+      if (--open == 0) port.close();
+    });
+  }
+  // Subscriptions are long-lived.
+  servers[1]!.closeAllConnections();
+}
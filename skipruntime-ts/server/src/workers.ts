@@ -0,0 +1,250 @@
+/**
+ * HTTP front ends running in worker threads.
+ *
+ * In this mode, the HTTP servers of a service run in several worker threads
+ * which all listen on the service's ports, while the reactive service runs
+ * on the main thread. Workers parse and serialize requests, responses, and
+ * streamed updates, and send the operations on the service as messages to
+ * the main thread. Collections of entries, i.e. writes, snapshots, and
+ * updates, are sent as binary frames (see `protocol.ts` in core) in buffers
+ * transferred rather than copied.
+ */
+
+import { Worker } from "node:worker_threads";
+import type {
+  Entry,
+  Json,
+  SubscriptionFilter,
+  SubscriptionID,
+  Watermark,
+} from "@skipruntime/core";
+import { encodeFrame, FrameDecoder } from "@skipruntime/core/protocol.js";
+import type { Service } from "./service.js";
+
+/**
+ * An operation on the service, requested by a worker.
+ */
+export type Call =
+  | {
+      method: "instantiateResource";
+      identifier: string;
+      resource: string;
+      params: Json;
+    }
+  | { method: "closeResourceInstance"; identifier: string }
+  | { method: "getAll"; resource: string; params: Json }
+  | { method: "getArray"; resource: string; key: Json; params: Json }
+  | { method: "getArrays"; resource: string; keys: Json[]; params: Json }
+  | { method: "update"; collection: string; frame: Uint8Array }
+  | {
+      method: "subscribe";
+      identifier: string;
+      watermark?: string;
+      filter?: SubscriptionFilter;
+    }
+  | { method: "unsubscribe"; subscription: SubscriptionID };
+
+/**
+ * Message from a worker to the main thread.
+ */
+export type WorkerMessage =
+  | { kind: "call"; id: number; call: Call }
+  | { kind: "ready" };
+
+/**
+ * Message from the main thread to a worker. Results, errors, and the
+ * notifications of subscriptions refer to the `id` of the call.
+ */
+export type ServiceMessage =
+  | { kind: "result"; id: number; value: unknown }
+  | { kind: "error"; id: number; name: string; message: string }
+  | { kind: "subscribed"; id: number }
+  | { kind: "notify"; id: number; frame: Uint8Array }
+  | { kind: "close"; id: number }
+  | { kind: "shutdown" };
+
+/**
+ * Configuration of the HTTP servers of a worker.
+ */
+export type WorkerOptions = {
+  control_port: number;
+  streaming_port: number;
+  no_cors?: boolean;
+  coalesce_ms?: number;
+};
+
+/**
+ * Encode entries as a binary frame.
+ */
+export function encodeEntries(entries: Entry<Json, Json>[]): Uint8Array {
+  return encodeFrame({ values: entries, watermark: "" as Watermark });
+}
+
+/**
+ * Decode entries encoded by `encodeEntries`.
+ */
+export function decodeEntries(frame: Uint8Array): Entry<Json, Json>[] {
+  return new FrameDecoder().push(frame)[0]!.values;
+}
+
+/**
+ * Start worker threads serving the HTTP APIs of a service.
+ *
+ * @param service - The service, running on the current thread.
+ * @param count - Number of workers.
+ * @param options - Configuration of the HTTP servers.
+ * @returns The workers, once they all listen.
+ */
+export async function startWorkers(
+  service: Service,
+  count: number,
+  options: WorkerOptions,
+): Promise<Worker[]> {
+  const workers: Worker[] = [];
+  const ready: Promise<void>[] = [];
+  for (let i = 0; i < count; i++) {
+    const worker = new Worker(new URL("./worker.js", import.meta.url), {
+      workerData: options,
+    });
+    workers.push(worker);
+    // The subscriptions opened by the worker, which its clients can no
+    // longer close once it exited.
+    const subscriptions = new Set<SubscriptionID>();
+    exits.set(
+      worker,
+      new Promise((resolve) => {
+        worker.once("exit", () => {
+          for (const subscription of subscriptions) {
+            service.unsubscribe(subscription);
+          }
+          subscriptions.clear();
+          resolve();
+        });
+      }),
+    );
+    ready.push(
+      new Promise((resolve, reject) => {
+        worker.on("error", (e: unknown) => {
+          console.error("Worker error:", e);
+          reject(e as Error);
+        });
+        worker.once("exit", (code) => {
+          reject(new Error(`Worker exited with code ${code.toString()}`));
+        });
+        worker.on("message", (msg: WorkerMessage) => {
+          if (msg.kind == "ready") resolve();
+          else serve(service, worker, subscriptions, msg.id, msg.call);
+        });
+      }),
+    );
+  }
+  try {
+    await Promise.all(ready);
+  } catch (e: unknown) {
+    await stopWorkers(workers);
+    throw e;
+  }
+  return workers;
+}
+
+/**
+ * Stop workers started by `startWorkers`, once they closed their servers.
+ */
+export async function stopWorkers(workers: Worker[]): Promise<void> {
+  await Promise.all(
+    workers.map((worker) => {
+      // Posting to a worker that already exited is a no-op.
+      worker.postMessage({ kind: "shutdown" } satisfies ServiceMessage);
+      return exits.get(worker);
+    }),
+  );
+}
+
+// Resolved once each worker started by `startWorkers` exited, whether
+// stopped or crashed.
+const exits = new WeakMap<Worker, Promise<void>>();
+
+function serve(
+  service: Service,
+  worker: Worker,
+  subscriptions: Set<SubscriptionID>,
+  id: number,
+  call: Call,
+) {
+  const post = (msg: ServiceMessage, frame?: Uint8Array) => {
+    worker.postMessage(msg, frame ? [frame.buffer as ArrayBuffer] : []);
+  };
+  let result: Promise<unknown>;
+  switch (call.method) {
+    case "instantiateResource":
+      result = service.instantiateResource(
+        call.identifier,
+        call.resource,
+        call.params,
+      );
+      break;
+    case "closeResourceInstance":
+      result = service.closeResourceInstance(call.identifier);
+      break;
+    case "getAll":
+      result = service.getAll(call.resource, call.params).then(encodeEntries);
+      break;
+    case "getArray":
+      result = service.getArray(call.resource, call.key, call.params);
+      break;
+    case "getArrays":
+      result = service.getArrays(call.resource, call.keys, call.params);
+      break;
+    case "update":
+      result = service.update(call.collection, decodeEntries(call.frame));
+      break;
+    case "subscribe":
+      result = service.subscribe(
+        call.identifier,
+        {
+          subscribed: () => {
+            post({ kind: "subscribed", id });
+          },
+          notify: (update) => {
+            const frame = encodeFrame(update);
+            post({ kind: "notify", id, frame }, frame);
+          },
+          close: () => {
+            post({ kind: "close", id });
+          },
+        },
+        call.watermark,
+        call.filter,
+      ).then((subscription) => {
+        if (worker.threadId == -1) {
+          // The worker exited while the subscription was being opened.
+          service.unsubscribe(subscription);
+        } else {
+          subscriptions.add(subscription);
+        }
+        return subscription;
+      });
+      break;
+    case "unsubscribe":
+      subscriptions.delete(call.subscription);
+      service.unsubscribe(call.subscription);
+      return;
+  }
+  result.then(
+    (value) => {
+      if (value instanceof Uint8Array) {
+        post({ kind: "result", id, value }, value);
+      } else {
+        post({ kind: "result", id, value });
+      }
+    },
+    (e: unknown) => {
+      post({
+        kind: "error",
+        id,
+        name: e instanceof Error ? e.constructor.name : "Error",
+        message: e instanceof Error ? e.message : JSON.stringify(e),
+      });
+    },
+  );
+}
@@ -0,0 +1,93 @@
+import type { CollectionUpdate, Json, Watermark } from "@skipruntime/core";
+import { SkipProtocolError } from "@skipruntime/core";
+import { encodeFrame, FrameDecoder } from "@skipruntime/core/protocol.js";
+import { UpdateStream } from "../src/sse.js";
+import { expect } from "chai";
+
+const init: CollectionUpdate<Json, Json> = {
+  values: [
+    [
+      "key",
+      [
+        0,
+        -1,
+        Number.MAX_SAFE_INTEGER,
+        Number.MIN_SAFE_INTEGER,
+        1.5,
+        2 ** 60,
+        true,
+        false,
+        "héllo €",
+        "x".repeat(200),
+        [1, [null, {}]],
+        { a: null, b: { c: ["d"] } },
+      ],
+    ],
+    [42, []],
+  ],
+  watermark: "17" as Watermark,
+  isInitial: true,
+};
+
+const update: CollectionUpdate<Json, Json> = {
+  values: [[{ id: 1 }, ["v"]]],
+  watermark: "18" as Watermark,
+  isInitial: false,
+};
+
+function concat(chunks: Uint8Array[]): Uint8Array {
+  const bytes = new Uint8Array(chunks.reduce((n, c) => n + c.length, 0));
+  let pos = 0;
+  for (const chunk of chunks) {
+    bytes.set(chunk, pos);
+    pos += chunk.length;
+  }
+  return bytes;
+}
+
+describe("Binary stream frames", function () {
+  it("round-trip updates", function () {
+    const decoder = new FrameDecoder();
+    expect(decoder.push(encodeFrame(init))).to.deep.equal([init]);
+    expect(decoder.push(encodeFrame(update))).to.deep.equal([update]);
+    expect(decoder.isComplete()).to.be.true;
+  });
+
+  it("are decoded across chunk boundaries", function () {
+    const bytes = concat([encodeFrame(init), encodeFrame(update)]);
+    for (const size of [1, 2, 7, 64]) {
+      const decoder = new FrameDecoder();
+      const updates = [];
+      for (let i = 0; i < bytes.length; i += size) {
+        updates.push(...decoder.push(bytes.subarray(i, i + size)));
+      }
+      expect(updates).to.deep.equal([init, update]);
+      expect(decoder.isComplete()).to.be.true;
+    }
+  });
+
+  it("reject malformed input", function () {
+    const frame = encodeFrame(update);
+    frame[0] = 9;
+    expect(() => new FrameDecoder().push(frame)).to.throw(SkipProtocolError);
+  });
+
+  it("are written by update streams", function () {
+    const chunks: Uint8Array[] = [];
+    const sink = {
+      write: (chunk: string | Uint8Array) => {
+        chunks.push(chunk as Uint8Array);
+        return true;
+      },
+      once: () => sink,
+      end: () => sink,
+    };
+    const stream = new UpdateStream(sink, 0, encodeFrame);
+    stream.notify(init);
+    stream.notify(update);
+    expect(new FrameDecoder().push(concat(chunks))).to.deep.equal([
+      init,
+      update,
+    ]);
+  });
+});
@@ -0,0 +1,97 @@
+import { runService, type SkipServer } from "../src/server.js";
+import type { Context, EagerCollection, Resource } from "@skipruntime/core";
+import { expect } from "chai";
+
+type Post = { title: string; body: string };
+
+type Inputs = {
+  posts: EagerCollection<number, Post>;
+};
+
+class PostsResource implements Resource<Inputs> {
+  instantiate(collections: Inputs): EagerCollection<number, Post> {
+    return collections.posts;
+  }
+}
+
+const control = "http://localhost:8085";
+const streaming = "http://localhost:8084";
+
+async function createStream(): Promise<string> {
+  const resp = await fetch(`${control}/v1/streams/posts`, {
+    method: "POST",
+    headers: { "Content-Type": "application/json" },
+    body: "{}",
+  });
+  return resp.text();
+}
+
+describe("stream filters", function () {
+  let service: SkipServer;
+  let uuid: string;
+  before(async function () {
+    service = await runService(
+      {
+        initialData: { posts: [[1, [{ title: "a", body: "b" }]]] },
+        resources: { posts: PostsResource },
+        createGraph(inputs: Inputs, _context: Context): Inputs {
+          return inputs;
+        },
+      },
+      {
+        control_port: 8085,
+        streaming_port: 8084,
+      },
+    );
+    uuid = await createStream();
+  });
+  after(async function () {
+    await fetch(`${control}/v1/streams/${uuid}`, { method: "DELETE" });
+    await service.close();
+  });
+
+  for (const query of [
+    "keys=1",
+    "keys=[1,null]",
+    "keys=[1",
+    "start=1",
+    "end=2",
+    "start=null&end=2",
+  ]) {
+    it(`rejects ?${query}`, async function () {
+      const resp = await fetch(`${streaming}/v1/streams/${uuid}?${query}`, {
+        headers: { Accept: "text/event-stream" },
+      });
+      expect(resp.status).to.equal(400);
+    });
+  }
+
+  it("sends only the requested fields", async function () {
+    const controller = new AbortController();
+    const resp = await fetch(
+      `${streaming}/v1/streams/${uuid}?fields=title,__pointer,keys,toJSON`,
+      {
+        headers: { Accept: "text/event-stream" },
+        signal: controller.signal,
+      },
+    );
+    expect(resp.status).to.equal(200);
+    const reader = resp.body!.getReader();
+    const decoder = new TextDecoder();
+    let text = "";
+    try {
+      while (!text.includes("\n\n")) {
+        const { done, value } = await reader.read();
+        if (done) throw new Error("Stream ended before the init event");
+        text += decoder.decode(value, { stream: true });
+      }
+    } finally {
+      controller.abort();
+    }
+    const [kind, , data] = text.split("\n\n")[0]!.split("\n");
+    expect(kind).to.equal("event: init");
+    expect(JSON.parse(data!.slice("data: ".length))).to.deep.equal([
+      [1, [{ title: "a" }]],
+    ]);
+  });
+});
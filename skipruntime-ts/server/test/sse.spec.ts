@@ -0,0 +1,132 @@
+import { UpdateStream, type EventSink } from "../src/sse.js";
+import { expect } from "chai";
+
+class FakeSink implements EventSink {
+  chunks: string[] = [];
+  full = false;
+  ended = false;
+  private drain: (() => void) | null = null;
+
+  write(chunk: string): boolean {
+    this.chunks.push(chunk);
+    return !this.full;
+  }
+
+  once(_event: "drain", listener: () => void): this {
+    this.drain = listener;
+    return this;
+  }
+
+  end(): this {
+    this.ended = true;
+    return this;
+  }
+
+  resume(): void {
+    this.full = false;
+    const drain = this.drain;
+    this.drain = null;
+    if (drain) drain();
+  }
+}
+
+function event(kind: string, watermark: string, values: unknown): string {
+  return `event: ${kind}\nid: ${watermark}\ndata: ${JSON.stringify(values)}\n\n`;
+}
+
+describe("UpdateStream", function () {
+  it("writes each update as a single event", function () {
+    const sink = new FakeSink();
+    const stream = new UpdateStream(sink);
+    stream.notify({ values: [["a", [1]]], watermark: "1", isInitial: true });
+    stream.notify({ values: [["a", [2]]], watermark: "2" });
+    expect(sink.chunks).to.deep.equal([
+      event("init", "1", [["a", [1]]]),
+      event("update", "2", [["a", [2]]]),
+    ]);
+  });
+
+  it("merges updates while the client is not reading", function () {
+    const sink = new FakeSink();
+    const stream = new UpdateStream(sink);
+    sink.full = true;
+    stream.notify({ values: [["a", [1]]], watermark: "1" });
+    const second: [string, number[]][] = [["b", [2]]];
+    stream.notify({ values: second, watermark: "2" });
+    stream.notify({ values: [["a", [3]], ["c", []]], watermark: "3" });
+    stream.notify({ values: [["b", [4]]], watermark: "4" });
+    expect(sink.chunks).to.have.length(1);
+    expect(second).to.deep.equal([["b", [2]]]);
+    sink.resume();
+    expect(sink.chunks).to.deep.equal([
+      event("update", "1", [["a", [1]]]),
+      event("update", "4", [
+        ["b", [4]],
+        ["a", [3]],
+        ["c", []],
+      ]),
+    ]);
+  });
+
+  it("merges updates into a pending initial snapshot", function () {
+    const sink = new FakeSink();
+    const stream = new UpdateStream(sink);
+    sink.full = true;
+    stream.notify({ values: [["x", [0]]], watermark: "1" });
+    stream.notify({
+      values: [
+        ["a", [1]],
+        ["b", [2]],
+      ],
+      watermark: "2",
+      isInitial: true,
+    });
+    stream.notify({
+      values: [
+        ["a", []],
+        ["c", [3]],
+      ],
+      watermark: "3",
+    });
+    sink.resume();
+    expect(sink.chunks[1]).to.equal(
+      event("init", "3", [
+        ["b", [2]],
+        ["c", [3]],
+      ]),
+    );
+  });
+
+  it("coalesces updates within the delay", async function () {
+    const sink = new FakeSink();
+    const stream = new UpdateStream(sink, 10);
+    stream.notify({ values: [["a", [1]]], watermark: "1" });
+    stream.notify({ values: [["a", [2]]], watermark: "2" });
+    expect(sink.chunks).to.be.empty;
+    await new Promise((resolve) => setTimeout(resolve, 30));
+    expect(sink.chunks).to.deep.equal([event("update", "2", [["a", [2]]])]);
+  });
+
+  it("flushes pending updates on close", function () {
+    const sink = new FakeSink();
+    const stream = new UpdateStream(sink, 1000);
+    stream.notify({ values: [["a", [1]]], watermark: "1" });
+    stream.close();
+    expect(sink.chunks).to.deep.equal([event("update", "1", [["a", [1]]])]);
+    expect(sink.ended).to.be.true;
+  });
+
+  it("writes pending updates on close when blocked", function () {
+    const sink = new FakeSink();
+    const stream = new UpdateStream(sink);
+    sink.full = true;
+    stream.notify({ values: [["a", [1]]], watermark: "1" });
+    stream.notify({ values: [["b", [2]]], watermark: "2" });
+    stream.close();
+    expect(sink.chunks).to.deep.equal([
+      event("update", "1", [["a", [1]]]),
+      event("update", "2", [["b", [2]]]),
+    ]);
+    expect(sink.ended).to.be.true;
+  });
+});
@@ -0,0 +1,164 @@
+import { runService, type SkipServer } from "../src/server.js";
+import type { Service } from "../src/service.js";
+import { startWorkers, stopWorkers } from "../src/workers.js";
+import type {
+  Context,
+  EagerCollection,
+  Resource,
+  SubscriptionID,
+} from "@skipruntime/core";
+import { expect } from "chai";
+
+type Inputs = {
+  items: EagerCollection<number, string>;
+};
+
+class ItemsResource implements Resource<Inputs> {
+  instantiate(collections: Inputs): EagerCollection<number, string> {
+    return collections.items;
+  }
+}
+
+const control = "http://localhost:8083";
+const streaming = "http://localhost:8082";
+
+// Reads the server-sent events of `reader` until one of kind `kind`.
+async function nextEvent(
+  reader: ReadableStreamDefaultReader<Uint8Array>,
+  kind: string,
+): Promise<unknown> {
+  const decoder = new TextDecoder();
+  let text = "";
+  for (;;) {
+    const events = text.split("\n\n");
+    for (const event of events.slice(0, -1)) {
+      const lines = event.split("\n");
+      if (lines[0] == `event: ${kind}`) {
+        const data = lines.find((line) => line.startsWith("data: "))!;
+        return JSON.parse(data.slice("data: ".length));
+      }
+    }
+    text = events[events.length - 1]!;
+    const { done, value } = await reader.read();
+    if (done) throw new Error(`Stream ended before a ${kind} event`);
+    text += decoder.decode(value, { stream: true });
+  }
+}
+
+describe("runService({ workers: 2 })", function () {
+  let service: SkipServer;
+  before(async function () {
+    service = await runService(
+      {
+        initialData: { items: [[1, ["a"]]] },
+        resources: { items: ItemsResource },
+        createGraph(inputs: Inputs, _context: Context): Inputs {
+          return inputs;
+        },
+      },
+      {
+        control_port: 8083,
+        streaming_port: 8082,
+        workers: 2,
+      },
+    );
+  });
+  after(async function () {
+    await service.close();
+  });
+
+  it("serves reads and writes", async function () {
+    const write = await fetch(`${control}/v1/inputs/items`, {
+      method: "PATCH",
+      headers: { "Content-Type": "application/json" },
+      body: JSON.stringify([[2, ["b"]]]),
+    });
+    expect(write.status).to.equal(200);
+    const read = await fetch(`${control}/v1/snapshot/items`, {
+      method: "POST",
+      headers: { "Content-Type": "application/json" },
+      body: "{}",
+    });
+    expect(await read.json()).to.deep.equal([
+      [1, ["a"]],
+      [2, ["b"]],
+    ]);
+    const lookup = await fetch(`${control}/v1/snapshot/items/lookup`, {
+      method: "POST",
+      headers: { "Content-Type": "application/json" },
+      body: JSON.stringify({ key: 1, params: {} }),
+    });
+    expect(await lookup.json()).to.deep.equal(["a"]);
+  });
+
+  it("streams updates to subscribers", async function () {
+    const uuid = await (
+      await fetch(`${control}/v1/streams/items`, {
+        method: "POST",
+        headers: { "Content-Type": "application/json" },
+        body: "{}",
+      })
+    ).text();
+    const controller = new AbortController();
+    const resp = await fetch(`${streaming}/v1/streams/${uuid}`, {
+      headers: { Accept: "text/event-stream" },
+      signal: controller.signal,
+    });
+    expect(resp.status).to.equal(200);
+    const reader = resp.body!.getReader();
+    try {
+      const init = (await nextEvent(reader, "init")) as [number, string[]][];
+      expect(init).to.deep.include([1, ["a"]]);
+      await fetch(`${control}/v1/inputs/items`, {
+        method: "PATCH",
+        headers: { "Content-Type": "application/json" },
+        body: JSON.stringify([[3, ["c"]]]),
+      });
+      expect(await nextEvent(reader, "update")).to.deep.equal([[3, ["c"]]]);
+    } finally {
+      controller.abort();
+      await fetch(`${control}/v1/streams/${uuid}`, { method: "DELETE" });
+    }
+  });
+});
+
+describe("startWorkers", function () {
+  it("unsubscribes the subscriptions of a worker that exited", async function () {
+    const unsubscribed: SubscriptionID[] = [];
+    const unused = () => Promise.reject(new Error("Unused"));
+    const service: Service = {
+      instantiateResource: unused,
+      closeResourceInstance: unused,
+      getAll: unused,
+      getArray: unused,
+      getArrays: unused,
+      update: unused,
+      subscribe: (_identifier, notifier) => {
+        notifier.subscribed();
+        return Promise.resolve(1 as SubscriptionID);
+      },
+      unsubscribe: (id) => {
+        unsubscribed.push(id);
+      },
+    };
+    const workers = await startWorkers(service, 1, {
+      control_port: 8087,
+      streaming_port: 8086,
+    });
+    const controller = new AbortController();
+    try {
+      const resp = await fetch("http://localhost:8086/v1/streams/uuid", {
+        headers: { Accept: "text/event-stream" },
+        signal: controller.signal,
+      });
+      expect(resp.status).to.equal(200);
+      expect(unsubscribed).to.deep.equal([]);
+      await workers[0]!.terminate();
+      expect(unsubscribed).to.deep.equal([1]);
+    } finally {
+      controller.abort();
+      // Must not wait for the exit of the terminated worker again.
+      await stopWorkers(workers);
+    }
+  });
+});
@@ -12,7 +12,9 @@ import type {
   Resource,
   Entry,
   ExternalService,
+  JsonPattern,
   ServiceInstance,
+  CollectionUpdate,
 } from "@skipruntime/core";
 
 import { Count, Sum } from "@skipruntime/helpers";
@@ -378,9 +380,33 @@ class JsonParamsResource implements Resource<Input_NN> {
     return cs.input.map(OffsetMapper, this.offset);
   }
 }
+// Looks up the offset of each value in an array of offsets.
+class OffsetsMapper implements Mapper<number, number, number, number> {
+  constructor(private readonly offsets: readonly number[]) {}
+
+  mapEntry(k: number, vs: Values<number>): Iterable<[number, number]> {
+    return vs.toArray().map((v) => [k, v + this.offsets[v]!]);
+  }
+}
+
+class ArrayParamsResource implements Resource<Input_NN> {
+  private readonly offsets: readonly number[];
+
+  constructor(params: Json) {
+    this.offsets = (params as { offsets: number[] }).offsets;
+  }
+
+  instantiate(cs: Input_NN): EagerCollection<number, number> {
+    return cs.input.map(OffsetsMapper, this.offsets);
+  }
+}
+
 const jsonParamsService: SkipService<Input_NN, Input_NN> = {
   initialData: { input: [] },
-  resources: { jsonParams: JsonParamsResource },
+  resources: {
+    jsonParams: JsonParamsResource,
+    arrayParams: ArrayParamsResource,
+  },
   createGraph(inputs: Input_NN) {
     return inputs;
   },
@@ -417,15 +443,98 @@ class JSONExtractResource implements Resource<Input_NJP> {
   }
 }
 
+class CompiledJSONExtract
+  implements
+    Mapper<number, { value: JsonObject; pattern: string }, number, Json[]>
+{
+  private readonly pattern: JsonPattern;
+
+  constructor(
+    private readonly context: Context,
+    pattern: string,
+  ) {
+    this.pattern = context.compileJsonPattern(pattern);
+  }
+
+  mapEntry(
+    key: number,
+    values: Values<{ value: JsonObject; pattern: string }>,
+  ): Iterable<[number, Json[]]> {
+    const value = values.getUnique();
+    return Array([key, this.context.jsonExtract(value.value, this.pattern)]);
+  }
+}
+
+class CompiledJSONExtractResource implements Resource<Input_NJP> {
+  private readonly pattern: string;
+
+  constructor(params: Json) {
+    this.pattern = (params as { pattern: string }).pattern;
+  }
+
+  instantiate(
+    cs: Input_NJP,
+    context: Context,
+  ): EagerCollection<number, Json[]> {
+    return cs.input.map(CompiledJSONExtract, context, this.pattern);
+  }
+}
+
 const jsonExtractService: SkipService<Input_NJP, Input_NJP> = {
   initialData: { input: [] },
-  resources: { jsonExtract: JSONExtractResource },
+  resources: {
+    jsonExtract: JSONExtractResource,
+    compiledJsonExtract: CompiledJSONExtractResource,
+  },
 
   createGraph(inputCollections: Input_NJP) {
     return inputCollections;
   },
 };
 
+// testLargeValues
+
+type Item = { id: number; tags: string[] };
+
+class ItemsSummary
+  implements Mapper<number, { items: Item[] }, number, Json>
+{
+  mapEntry(
+    key: number,
+    values: Values<{ items: Item[] }>,
+  ): Iterable<[number, Json]> {
+    const items = values.getUnique().items;
+    return [
+      [
+        key,
+        {
+          count: items.length,
+          last: items[items.length - 1]!.id,
+          tagged: items.filter((item) => item.tags.length > 0).length,
+          first: items.slice(0, 2),
+          all: items,
+        },
+      ],
+    ];
+  }
+}
+
+type Input_NI = { input: EagerCollection<number, { items: Item[] }> };
+
+class LargeValuesResource implements Resource<Input_NI> {
+  instantiate(cs: Input_NI): EagerCollection<number, Json> {
+    return cs.input.map(ItemsSummary);
+  }
+}
+
+const largeValuesService: SkipService<Input_NI, Input_NI> = {
+  initialData: { input: [] },
+  resources: { largeValues: LargeValuesResource },
+  createGraph(inputs: Input_NI) {
+    return inputs;
+  },
+};
+
 //// testExternalService
 
 async function timeout(ms: number) {
@@ -1131,6 +1240,34 @@ export function initTests(
     ]);
   });
 
+  it("testArrayParams", async () => {
+    const service = await initService(jsonParamsService);
+    const resourceId = "unsafe.array.params";
+    // Large enough for its elements to be imported as they are read.
+    const offsets = Array.from({ length: 20 }, (_, i) => 100 * i);
+    service.instantiateResource(resourceId, "arrayParams", { offsets });
+    const updates: CollectionUpdate<number, number>[] = [];
+    try {
+      service.subscribe(resourceId, {
+        subscribed: () => {},
+        notify: (update: CollectionUpdate<number, number>) => {
+          updates.push(update);
+        },
+        close: () => {},
+      });
+      // The mapper reads elements of its parameter in later updates.
+      for (const v of [3, 17, 11]) {
+        service.update("input", [[v, [v]]]);
+        expect(updates[updates.length - 1]!.values).toEqual([
+          [v, [v + 100 * v]],
+        ]);
+      }
+    } finally {
+      service.closeResourceInstance(resourceId);
+      await service.close();
+    }
+  });
+
   it("testJSONExtract", async () => {
     const service = await initService(jsonExtractService);
     const resource = "jsonExtract";
@@ -1189,6 +1326,66 @@ export function initTests(
     ]);
   });
 
+  it("testCompiledJSONExtract", async () => {
+    const service = await initService(jsonExtractService);
+    service.update("input", [
+      [0, [{ value: { x: [1, 2], y: [4, 5] }, pattern: "" }]],
+      [1, [{ value: { x: [3], y: [7] }, pattern: "" }]],
+    ]);
+    expect(
+      service.getAll("compiledJsonExtract", {
+        pattern: "{x[]: var1, ?y[0]: var2}",
+      }).payload,
+    ).toEqual([
+      [
+        0,
+        [
+          [
+            [{ var2: 4 }, { var1: 1 }],
+            [{ var2: 4 }, { var1: 2 }],
+          ],
+        ],
+      ],
+      [1, [[[{ var2: 7 }, { var1: 3 }]]]],
+    ]);
+  });
+
+  it("testJSONExtractManyPatterns", async () => {
+    // More distinct patterns than the runtime keeps parsed at once.
+    const service = await initService(jsonExtractService);
+    const entries: Entry<number, { value: JsonObject; pattern: string }>[] =
+      Array.from({ length: 300 }, (_, i) => [
+        i,
+        [{ value: { x: i }, pattern: `{x: var${i}}` }],
+      ]);
+    service.update("input", entries);
+    service.update("input", [
+      [0, [{ value: { x: -1 }, pattern: "{x: var0}" }]],
+    ]);
+    const payload = service.getAll("jsonExtract").payload;
+    expect(payload.length).toEqual(300);
+    expect(payload[0]).toEqual([0, [[[{ var0: -1 }]]]]);
+    expect(payload[299]).toEqual([299, [[[{ var299: 299 }]]]]);
+  });
+
+  it("testLargeValues", async () => {
+    const service = await initService(largeValuesService);
+    const items = Array.from({ length: 1000 }, (_, id) => ({
+      id,
+      tags: id % 10 == 0 ? ["tenth"] : [],
+    }));
+    service.update("input", [[0, [{ items }]]]);
+    expect(service.getArray("largeValues", 0).payload).toEqual([
+      {
+        count: 1000,
+        last: 999,
+        tagged: 100,
+        first: items.slice(0, 2),
+        all: items,
+      },
+    ]);
+  });
+
   it("testExternal", async () => {
     const resource = "external";
     const service = await initService(testExternalService);
@@ -1235,6 +1432,121 @@ export function initTests(
     }
   });
 
+  it("testLoneSurrogates", async () => {
+    const service = await initService(map1Service);
+    // Strings are exported as UTF-8, with U+FFFD for lone low surrogates.
+    service.update("input", [["a\udc00", [10]]]);
+    expect(service.getAll("map1").payload).toEqual([["a\ufffd", [12]]]);
+  });
+
+  it("testGetArrays", async () => {
+    const service = await initService(map1Service);
+    service.update("input", [
+      ["1", [10]],
+      ["2", [20]],
+    ]);
+    expect(service.getArrays("map1", ["2", "3", "1"]).payload).toEqual([
+      [22],
+      [],
+      [12],
+    ]);
+    expect(service.getArrays("map1", []).payload).toEqual([]);
+  });
+
+  it("testResumeSubscription", async () => {
+    const service = await initService(map1Service);
+    service.update("input", [
+      ["1", [10]],
+      ["2", [20]],
+    ]);
+    const resourceId = "unsafe.resumed.resource";
+    service.instantiateResource(resourceId, "map1", {});
+    const updates: CollectionUpdate<string, number>[] = [];
+    const notifier = {
+      subscribed: () => {},
+      notify: (update: CollectionUpdate<string, number>) => {
+        updates.push(update);
+      },
+      close: () => {},
+    };
+    try {
+      service.unsubscribe(service.subscribe(resourceId, notifier));
+      expect(updates).toHaveLength(1);
+      expect(updates[0]!.isInitial).toEqual(true);
+      service.update("input", [["2", [30]]]);
+      // Only the changes since the last update received are sent.
+      service.unsubscribe(
+        service.subscribe(resourceId, notifier, updates[0]!.watermark),
+      );
+      expect(updates).toHaveLength(2);
+      expect(updates[1]!.isInitial).toEqual(false);
+      expect(updates[1]!.values).toEqual([["2", [32]]]);
+      // An unknown watermark falls back to the whole collection.
+      service.subscribe(resourceId, notifier, "unknown/1");
+      expect(updates).toHaveLength(3);
+      expect(updates[2]!.isInitial).toEqual(true);
+      expect(updates[2]!.values).toEqual([
+        ["1", [12]],
+        ["2", [32]],
+      ]);
+    } finally {
+      service.closeResourceInstance(resourceId);
+      await service.close();
+    }
+  });
+
+  it("testFilteredSubscription", async () => {
+    const service = await initService(largeValuesService);
+    const items = (n: number): Item[] =>
+      Array.from({ length: n }, (_, id) => ({ id, tags: [] }));
+    service.update(
+      "input",
+      [0, 1, 2, 3, 4, 5].map((key): [number, { items: Item[] }[]] => [
+        key,
+        [{ items: items(key + 1) }],
+      ]),
+    );
+    const resourceId = "unsafe.filtered.resource";
+    service.instantiateResource(resourceId, "largeValues", {});
+    const updates: CollectionUpdate<number, Json>[] = [];
+    try {
+      service.subscribe(
+        resourceId,
+        {
+          subscribed: () => {},
+          notify: (update: CollectionUpdate<number, Json>) => {
+            updates.push(update);
+          },
+          close: () => {},
+        },
+        undefined,
+        {
+          keys: [1],
+          range: { start: 3, end: 4 },
+          fields: ["count", "last", "unknown"],
+        },
+      );
+      expect(updates).toHaveLength(1);
+      expect(updates[0]!.values).toEqual([
+        [1, [{ count: 2, last: 1 }]],
+        [3, [{ count: 4, last: 3 }]],
+        [4, [{ count: 5, last: 4 }]],
+      ]);
+      // Changes to other keys are not notified.
+      service.update("input", [[0, [{ items: items(10) }]]]);
+      expect(updates).toHaveLength(1);
+      service.update("input", [
+        [2, [{ items: items(10) }]],
+        [3, [{ items: items(10) }]],
+      ]);
+      expect(updates).toHaveLength(2);
+      expect(updates[1]!.values).toEqual([[3, [{ count: 10, last: 9 }]]]);
+    } finally {
+      service.closeResourceInstance(resourceId);
+      await service.close();
+    }
+  });
+
   it("testMultipleResources", async () => {
     const service = await initService(multipleResourcesService);
     service.update("input1", [["1", [10]]]);
@@ -205,6 +205,13 @@ export interface FromWasm {
     request: ptr<Internal.Request> | null,
   ): ptr<Internal.CJObject | Internal.CJFloat>;
 
+  SkipRuntime_Runtime__getForKeys(
+    resource: ptr<Internal.String>,
+    params: ptr<Internal.CJSON>,
+    keys: ptr<Internal.CJArray<Internal.CJSON>>,
+    request: ptr<Internal.Request> | null,
+  ): ptr<Internal.CJObject | Internal.CJFloat>;
+
   SkipRuntime_Runtime__closeResource(
     identifier: ptr<Internal.String>,
   ): Handle<Error>;
@@ -213,6 +220,7 @@ export interface FromWasm {
     collection: ptr<Internal.String>,
     notifier: ptr<Internal.Notifier>,
     watermark: Nullable<ptr<Internal.String>>,
+    ranges: ptr<Internal.CJArray> | null,
   ): bigint;
 
   SkipRuntime_Runtime__unsubscribe(id: bigint): Handle<Error>;
@@ -243,9 +251,17 @@ export interface FromWasm {
 
   SkipRuntime_Context__jsonExtract(
     from: ptr<Internal.CJObject>,
-    pattern: ptr<Internal.String>,
+    pattern: ptr<Internal.JsonPattern>,
   ): ptr<Internal.CJArray>;
 
+  SkipRuntime_Context__compileJsonPattern(
+    pattern: ptr<Internal.String>,
+  ): ptr<Internal.JsonPattern>;
+
+  SkipRuntime_Context__dropJsonPattern(
+    pattern: ptr<Internal.JsonPattern>,
+  ): void;
+
   SkipRuntime_Context__useExternalResource(
     service: ptr<Internal.String>,
     identifier: ptr<Internal.String>,
@@ -638,9 +654,13 @@ export class WasmFromBinding implements FromBinding {
     resource: string,
     params: Pointer<Internal.CJSON>,
   ): Handle<Error> {
+    const [skIdentifier, skResource] = this.utils.exportStrings([
+      identifier,
+      resource,
+    ]);
     return this.fromWasm.SkipRuntime_Runtime__createResource(
-      this.utils.exportString(identifier),
-      this.utils.exportString(resource),
+      skIdentifier!,
+      skResource!,
       toPtr(params),
     );
   }
@@ -671,6 +691,20 @@ export class WasmFromBinding implements FromBinding {
     );
   }
 
+  SkipRuntime_Runtime__getForKeys(
+    resource: string,
+    params: Pointer<Internal.CJSON>,
+    keys: Pointer<Internal.CJArray<Internal.CJSON>>,
+    request: Pointer<Internal.Request> | null,
+  ): Pointer<Internal.CJObject | Internal.CJFloat> {
+    return this.fromWasm.SkipRuntime_Runtime__getForKeys(
+      this.utils.exportString(resource),
+      toPtr(params),
+      toPtr(keys),
+      toNullablePtr(request),
+    );
+  }
+
   SkipRuntime_Runtime__closeResource(identifier: string): Handle<Error> {
     return this.fromWasm.SkipRuntime_Runtime__closeResource(
       this.utils.exportString(identifier),
@@ -681,11 +715,13 @@ export class WasmFromBinding implements FromBinding {
     collection: string,
     notifier: Pointer<Internal.Notifier>,
     watermark: Nullable<string>,
+    ranges: Nullable<Pointer<Internal.CJArray>>,
   ): bigint {
     return this.fromWasm.SkipRuntime_Runtime__subscribe(
       this.utils.exportString(collection),
       toPtr(notifier),
       watermark ? this.utils.exportString(watermark) : null,
+      toNullablePtr(ranges),
     );
   }
 
@@ -728,23 +764,41 @@ export class WasmFromBinding implements FromBinding {
 
   SkipRuntime_Context__jsonExtract(
     from: Pointer<Internal.CJObject>,
-    pattern: string,
+    pattern: Pointer<Internal.JsonPattern>,
   ): Pointer<Internal.CJArray> {
     return this.fromWasm.SkipRuntime_Context__jsonExtract(
       toPtr(from),
+      toPtr(pattern),
+    );
+  }
+
+  SkipRuntime_Context__compileJsonPattern(
+    pattern: string,
+  ): Pointer<Internal.JsonPattern> {
+    return this.fromWasm.SkipRuntime_Context__compileJsonPattern(
       this.utils.exportString(pattern),
     );
   }
 
+  SkipRuntime_Context__dropJsonPattern(
+    pattern: Pointer<Internal.JsonPattern>,
+  ): void {
+    this.fromWasm.SkipRuntime_Context__dropJsonPattern(toPtr(pattern));
+  }
+
   SkipRuntime_Context__useExternalResource(
     service: string,
     identifier: string,
     params: Pointer<Internal.CJSON>,
   ): string {
+    const [skService, skIdentifier] = this.utils.exportStrings([
+      service,
+      identifier,
+    ]);
     return this.utils.importString(
       this.fromWasm.SkipRuntime_Context__useExternalResource(
-        this.utils.exportString(service),
-        this.utils.exportString(identifier),
+        skService!,
+        skIdentifier!,
         toPtr(params),
       ),
     );
@@ -0,0 +1,18 @@
+create table t1(a TEXT);
+
+insert into t1 values ('abc');
+insert into t1 values ('abcd');
+insert into t1 values ('ABCDE');
+insert into t1 values ('bcde');
+insert into t1 values ('b.de');
+insert into t1 values ('cde');
+insert into t1 values ('a*c');
+
+select * from t1 where a glob 'abc*';
+select * from t1 where a glob 'b?de';
+select * from t1 where a glob 'b.de';
+select * from t1 where a glob '[ab]*';
+select * from t1 where a glob '[^ab]*';
+select * from t1 where a glob '*[d-e]';
+select * from t1 where a glob '*[*]*';
+select * from t1 where a not glob '*c*';
@@ -0,0 +1,28 @@
+create table t1(a TEXT);
+
+insert into t1 values ('abc');
+insert into t1 values ('abcd');
+insert into t1 values ('ABCDE');
+insert into t1 values ('bcde');
+insert into t1 values ('b.de');
+insert into t1 values ('cde');
+insert into t1 values ('a*c');
+insert into t1 values ('x12y');
+insert into t1 values ('aaab');
+
+select * from t1 where a regexp 'abc';
+select * from t1 where a regexp '^abc$';
+select * from t1 where a regexp 'b\.de';
+select * from t1 where a regexp '^[ab].*e$';
+select * from t1 where a regexp '^[^ab]';
+select * from t1 where a regexp 'a*b';
+select * from t1 where a regexp '^a+b$';
+select * from t1 where a regexp 'a\*c';
+select * from t1 where a regexp '\d+';
+select * from t1 where a regexp '^(abc|cde)$';
+select * from t1 where a regexp 'd?e$';
+select * from t1 where a not regexp 'c';
+
+-- Patterns seen before are taken from the cache of compiled regexes.
+select * from t1 where a regexp 'abc';
+select * from t1 where a regexp 'abc' and a not regexp '^abc$';